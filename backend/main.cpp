@@ -4,20 +4,47 @@
 #include <algorithm>
 #include <queue>
 #include <deque>
+#include <cmath>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <set>
+#include <tuple>
+#include <coroutine>
+#include <utility>
+#include <array>
+#include <sstream>
 
 using namespace std;
 
+// Deadline value of a process that has none
+const int noDeadline = INT_MAX;
+
 struct Process {
     int id;
     int burstTime;
     int arrivalTime;
     int priority;
+    int deadline = noDeadline; // absolute time
+    int tickets = 0; // proportional share; 0 derives it from priority
 
     int completionTime = 0;
     int turnaroundTime = 0;
     int waitingTime = 0;
     int responseTime = 0;
     bool started = false;
+    // Runs started on a CPU, and how many of them resumed a partly run burst
+    int dispatches = 0;
+    int preemptions = 0;
 };
 
 struct ProcessMetrics {
@@ -29,13 +56,106 @@ struct ProcessMetrics {
     int turnaroundTime;
     int waitingTime;
     int responseTime;
+    int deadline;
+    int dispatches = 0;
+    int preemptions = 0;
+
+    // Proportional-share engines only: service the job was entitled to while
+    // it was runnable, and its largest |entitled - received| along the way
+    int tickets = 0;
+    double idealService = 0;
+    double maxLag = 0;
 };
 
 
+// processId -1 marks an idle CPU, -2 context-switch overhead
 struct GanttEntry {
     int processId;
     int startTime;
     int endTime;
+    int cpu = 0;
+};
+
+const int idleProcessId = -1;
+
+// Deadline accounting over the processes that carry a deadline.
+// Lateness is completionTime - deadline (negative when early); tardiness
+// is lateness clamped at zero.
+struct DeadlineStats {
+    int jobs = 0;
+    int missed = 0;
+    double meanLateness = 0;
+    int minLateness = 0;
+    int p50Lateness = 0;
+    int p90Lateness = 0;
+    int p99Lateness = 0;
+    int maxLateness = 0;
+    int maxTardiness = 0;
+};
+
+// Achieved-share accounting of the proportional-share engines. The share
+// error of a job is (received - entitled) / entitled service at completion.
+struct ShareStats {
+    int jobs = 0;
+    double meanAbsShareError = 0;
+    double maxAbsShareError = 0;
+    double maxLag = 0;
+};
+
+// Jobs that waited longer than the requested threshold
+struct StarvationStats {
+    int threshold = 0;
+    int starved = 0;
+};
+
+// Nearest-rank percentiles of a per-process time
+struct LatencyPercentiles {
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    int max = 0;
+};
+
+// Outcome of one priority class; with many distinct priorities, adjacent
+// ones are merged and the class covers [minPriority, maxPriority]
+struct PriorityClassStats {
+    int minPriority = 0;
+    int maxPriority = 0;
+    int jobs = 0;
+    double avgWaitingTime = 0;
+    double avgResponseTime = 0;
+    double avgTurnaroundTime = 0;
+    double meanSlowdown = 0;
+    double maxSlowdown = 0;
+    int maxWaitingTime = 0;
+};
+
+// Slowdown is turnaround / burst (bursts under 1 count as 1). Jain's index
+// (sum x)^2 / (n * sum x^2) is 1 when all jobs are slowed down equally and
+// falls towards 1/n as a few jobs absorb the delay.
+struct FairnessStats {
+    double jainIndex = 0;
+    double meanSlowdown = 0;
+    double maxSlowdown = 0;
+    vector<PriorityClassStats> classes;
+};
+
+// Device side of CPU/I-O simulations
+struct IoStats {
+    vector<double> deviceUtilization; // percent of the makespan, per device
+    double overlap = 0; // percent of the makespan with the CPU and a device both busy
+    double avgIoWaitTime = 0; // queueing delay per I/O burst
+    vector<GanttEntry> ioChart; // cpu holds the device
+    int blocked = 0; // processes left waiting on an event that never came
+};
+
+// Downsampled CPU utilization (percent of capacity) and mean ready-queue
+// length, one point per bucketWidth time units from time 0
+struct Timeline {
+    int bucketWidth = 0;
+    vector<double> utilization;
+    vector<double> readyQueue;
 };
 
 struct AlgorithmResult {
@@ -47,42 +167,533 @@ struct AlgorithmResult {
     double avgResponseTime;
     double throughput;
     double avgCompletionTime;
+    int contextSwitches = 0;
+    int migrations = 0;
+    int preemptions = 0;
+    LatencyPercentiles waitingPercentiles;
+    LatencyPercentiles responsePercentiles;
+    LatencyPercentiles turnaroundPercentiles;
+    int makespan = 0;
+    // Time spent in context-switch overhead, and the share (percent) of CPU
+    // capacity over the makespan that went to useful work
+    int overheadTime = 0;
+    double cpuUtilization = 0;
+    // CPU time over the makespan (summed over CPUs) spent neither on jobs nor on overhead
+    long long idleTime = 0;
+    Timeline timeline;
+    DeadlineStats deadlines;
+    ShareStats shares;
+    StarvationStats starvation;
+    FairnessStats fairness;
+    IoStats io;
 };
 
-vector<Process> generateRandomProcesses(int count) {
-    vector<Process> processes;
-    random_device rd;
-    mt19937 gen(rd());
+// Controls which per-run artifacts the engines return besides the averages.
+// Sweeps and batch runs turn both off to keep results small.
+struct SimOptions {
+    bool recordGantt = true;
+    bool recordProcesses = true;
+    // Waits longer than this count as starved (0 disables the count)
+    int starvationThreshold = 0;
+    // Initial bucket width of the timeline (0: no timeline); the width
+    // doubles as needed to stay within timelinePoints buckets
+    int timelineBucket = 0;
+    int timelinePoints = 500;
+};
+
+// Online accumulator behind Timeline. Intervals may arrive in any order and
+// cost O(1) each: the buckets at their ends get partial sums, the ones they
+// cover fully go through a difference array. An interval ending past the
+// last bucket doubles the width and merges neighbouring buckets, so memory
+// stays at timelinePoints buckets however long the trace runs.
+class TimelineRecorder {
+public:
+    explicit TimelineRecorder(const SimOptions& options)
+        : width(options.timelineBucket), points(std::max(options.timelinePoints, 1)) {
+        if (enabled()) {
+            for (int channel = 0; channel < channels; channel++) {
+                partial[channel].assign(points, 0);
+                covered[channel].assign(points + 1, 0);
+            }
+        }
+    }
 
-    uniform_int_distribution<> burstTimeDist(1, 100);
-    uniform_int_distribution<> arrivalTimeDist(0, count < 10 ? 10 : count * 2);
-    uniform_int_distribution<> priorityDist(1, count*2);
+    bool enabled() const { return width > 0; }
 
-    for (int i = 1; i <= count; i++) {
-        Process p;
-        p.id = i;
-        p.burstTime = burstTimeDist(gen);
-        p.arrivalTime = arrivalTimeDist(gen);
-        p.priority = priorityDist(gen);
-        processes.push_back(p);
+    // `weight` CPUs doing useful work over [start, end)
+    void addBusy(long long start, long long end, long long weight = 1) { add(busyChannel, start, end, weight); }
+    // `weight` more jobs in the ready queue over [start, end)
+    void addReady(long long start, long long end, long long weight = 1) { add(readyChannel, start, end, weight); }
+
+    Timeline finish(long long horizon, int cpuCount) {
+        Timeline timeline;
+        if (!enabled() || horizon <= 0) {
+            return timeline;
+        }
+        while (horizon > width * static_cast<long long>(points)) {
+            grow();
+        }
+        vector<long long> busy = totals(busyChannel);
+        vector<long long> ready = totals(readyChannel);
+        size_t used = static_cast<size_t>((horizon + width - 1) / width);
+        timeline.bucketWidth = static_cast<int>(std::min<long long>(width, INT_MAX));
+        for (size_t k = 0; k < used; k++) {
+            // The last bucket may be cut short by the horizon
+            double span = static_cast<double>(std::min(width, horizon - static_cast<long long>(k) * width));
+            timeline.utilization.push_back(100.0 * busy[k] / (span * cpuCount));
+            timeline.readyQueue.push_back(ready[k] / span);
+        }
+        return timeline;
     }
 
-    return processes;
+private:
+    static constexpr int channels = 2;
+    static constexpr int busyChannel = 0;
+    static constexpr int readyChannel = 1;
+
+    void add(int channel, long long start, long long end, long long weight) {
+        if (!enabled() || end <= start || weight == 0) {
+            return;
+        }
+        while (end > width * static_cast<long long>(points)) {
+            grow();
+        }
+        size_t first = static_cast<size_t>(start / width);
+        size_t last = static_cast<size_t>(end / width);
+        if (first == last) {
+            partial[channel][first] += weight * (end - start);
+            return;
+        }
+        partial[channel][first] += weight * (static_cast<long long>(first + 1) * width - start);
+        if (last < points) {
+            partial[channel][last] += weight * (end - static_cast<long long>(last) * width);
+        }
+        covered[channel][first + 1] += weight;
+        covered[channel][last] -= weight;
+    }
+
+    // Per-bucket integral of a channel
+    vector<long long> totals(int channel) const {
+        vector<long long> result(points);
+        long long level = 0;
+        for (size_t k = 0; k < points; k++) {
+            level += covered[channel][k];
+            result[k] = partial[channel][k] + level * width;
+        }
+        return result;
+    }
+
+    void grow() {
+        for (int channel = 0; channel < channels; channel++) {
+            vector<long long> merged = totals(channel);
+            for (size_t k = 0; k < points; k++) {
+                size_t left = 2 * k;
+                partial[channel][k] = (left < points ? merged[left] : 0) + (left + 1 < points ? merged[left + 1] : 0);
+            }
+            fill(covered[channel].begin(), covered[channel].end(), 0);
+        }
+        width *= 2;
+    }
+
+    long long width;
+    size_t points;
+    vector<long long> partial[channels];
+    vector<long long> covered[channels];
+};
+
+// Timeline of a work-conserving single-CPU schedule: the CPU is busy exactly
+// while jobs are present, so busy periods follow from arrivals and bursts
+// alone, and everyone present but the running job is in the ready queue.
+// Works on both Process and ProcessMetrics rows.
+template <typename Job>
+Timeline singleCpuTimeline(const vector<Job>& jobs, int makespan, const SimOptions& options) {
+    TimelineRecorder recorder(options);
+    vector<pair<int, int>> arrivals;
+    arrivals.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        recorder.addReady(job.arrivalTime, job.completionTime);
+        arrivals.push_back({job.arrivalTime, job.burstTime});
+    }
+    sort(arrivals.begin(), arrivals.end());
+    long long periodStart = 0;
+    long long periodEnd = 0;
+    for (const auto& [arrival, burst] : arrivals) {
+        if (arrival > periodEnd) {
+            recorder.addBusy(periodStart, periodEnd);
+            recorder.addReady(periodStart, periodEnd, -1);
+            periodStart = arrival;
+            periodEnd = arrival;
+        }
+        periodEnd += burst;
+    }
+    recorder.addBusy(periodStart, periodEnd);
+    recorder.addReady(periodStart, periodEnd, -1);
+    return recorder.finish(makespan, 1);
+}
+
+// 0-based index of the nearest-rank q-percentile (q in [0, 1]) of n values
+size_t nearestRankIndex(double q, size_t n) {
+    size_t rank = static_cast<size_t>(ceil(q * n));
+    return rank == 0 ? 0 : rank - 1;
+}
+
+// Nearest-rank percentile (q in [0, 1]); reorders values
+double percentile(vector<int>& values, double q) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = nearestRankIndex(q, values.size());
+    nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Distribution of a non-negative time, recorded in one pass. Up to
+// exactLimit values are kept as-is and give exact percentiles; past that they
+// move into an HDR-style log histogram (128 sub-buckets per power of two), so
+// memory stays bounded and percentiles are within 1/256 of the true value.
+class LatencyHistogram {
+public:
+    void record(int value) {
+        value = std::max(value, 0);
+        total++;
+        largest = std::max(largest, value);
+        smallest = std::min(smallest, value);
+        if (buckets.empty()) {
+            if (values.size() < exactLimit) {
+                values.push_back(value);
+                return;
+            }
+            buckets.assign(bucketCount, 0);
+            for (int v : values) {
+                buckets[bucketIndex(v)]++;
+            }
+            values.clear();
+            values.shrink_to_fit();
+        }
+        buckets[bucketIndex(value)]++;
+    }
+
+    LatencyPercentiles percentiles() {
+        LatencyPercentiles result;
+        if (total == 0) {
+            return result;
+        }
+        const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+        double* targets[] = {&result.p50, &result.p90, &result.p99, &result.p999};
+        result.max = largest;
+        if (buckets.empty()) {
+            sort(values.begin(), values.end());
+            for (int k = 0; k < 4; k++) {
+                *targets[k] = values[nearestRankIndex(quantiles[k], values.size())];
+            }
+            return result;
+        }
+        // One cumulative scan serves the (increasing) ranks of all quantiles
+        size_t seen = 0;
+        int k = 0;
+        for (size_t index = 0; index < buckets.size() && k < 4; index++) {
+            seen += buckets[index];
+            while (k < 4 && nearestRankIndex(quantiles[k], total) < seen) {
+                *targets[k++] = std::clamp(bucketMidpoint(index), smallest, largest);
+            }
+        }
+        return result;
+    }
+
+    // Histogram bucket of a non-negative value; monotone in the value
+    static size_t bucketIndex(int value) {
+        if (value < (1 << subBucketBits)) {
+            return value;
+        }
+        int shift = (31 - __builtin_clz(static_cast<unsigned>(value))) - (subBucketBits - 1);
+        return static_cast<size_t>(shift) * halfSubBuckets + (value >> shift);
+    }
+
+private:
+    static constexpr size_t exactLimit = 4096;
+    static constexpr int subBucketBits = 8;
+    static constexpr int halfSubBuckets = 1 << (subBucketBits - 1);
+    // Values below 2^subBucketBits map to themselves; above, each power of
+    // two splits into halfSubBuckets buckets (up to INT_MAX)
+    static constexpr size_t bucketCount = (31 - subBucketBits + 2) * halfSubBuckets;
+
+    static int bucketMidpoint(size_t index) {
+        if (index < (1u << subBucketBits)) {
+            return static_cast<int>(index);
+        }
+        int shift = static_cast<int>(index / halfSubBuckets) - 1;
+        long long low = static_cast<long long>(index - static_cast<size_t>(shift) * halfSubBuckets) << shift;
+        return static_cast<int>(std::min<long long>(low + ((1LL << shift) - 1) / 2, INT_MAX));
+    }
+
+    vector<int> values;
+    vector<uint64_t> buckets;
+    size_t total = 0;
+    int smallest = INT_MAX;
+    int largest = 0;
+};
+
+// Report at most this many priority classes
+const int maxPriorityClasses = 32;
+// Distinct priorities tracked exactly; past that, priorities are grouped
+// into log-spaced ranges first
+const size_t exactPriorityLimit = 4096;
+
+// Per-job completion hook of the engines' metrics pass: accumulates the
+// latency distributions, starvation count and slowdown fairness in one go,
+// so none of it needs the per-process rows
+class CompletionRecorder {
+public:
+    explicit CompletionRecorder(int starvationThreshold) : starvationThreshold(starvationThreshold) {}
+
+    void record(int waitingTime, int responseTime, int turnaroundTime, int burstTime, int priority) {
+        waiting.record(waitingTime);
+        response.record(responseTime);
+        turnaround.record(turnaroundTime);
+        starved += starvationThreshold > 0 && waitingTime > starvationThreshold ? 1 : 0;
+
+        double slowdown = static_cast<double>(turnaroundTime) / std::max(burstTime, 1);
+        jobs++;
+        slowdownSum += slowdown;
+        slowdownSquares += slowdown * slowdown;
+        maxSlowdown = std::max(maxSlowdown, slowdown);
+
+        // Workloads tend to repeat the same priority: skip the lookup then
+        if (current == nullptr || priority != currentPriority) {
+            if (!coarse && classes.size() >= exactPriorityLimit) {
+                coarsen();
+            }
+            current = &classes[coarse ? coarseKey(priority) : priority];
+            currentPriority = priority;
+        }
+        if (current->jobs == 0 || priority < current->minPriority) {
+            current->minPriority = priority;
+        }
+        current->maxPriority = std::max(current->maxPriority, priority);
+        current->jobs++;
+        current->waiting += waitingTime;
+        current->response += responseTime;
+        current->turnaround += turnaroundTime;
+        current->slowdown += slowdown;
+        current->maxSlowdown = std::max(current->maxSlowdown, slowdown);
+        current->maxWaitingTime = std::max(current->maxWaitingTime, waitingTime);
+    }
+
+    void finish(AlgorithmResult& result) {
+        result.waitingPercentiles = waiting.percentiles();
+        result.responsePercentiles = response.percentiles();
+        result.turnaroundPercentiles = turnaround.percentiles();
+        result.starvation.threshold = starvationThreshold;
+        result.starvation.starved = starved;
+
+        FairnessStats& fairness = result.fairness;
+        if (jobs == 0) {
+            return;
+        }
+        fairness.meanSlowdown = slowdownSum / jobs;
+        fairness.maxSlowdown = maxSlowdown;
+        fairness.jainIndex = slowdownSquares > 0 ? slowdownSum * slowdownSum / (jobs * slowdownSquares) : 1;
+
+        // Merge adjacent priorities into classes of at least jobs / maxPriorityClasses
+        vector<pair<int, ClassTotals>> sorted(classes.begin(), classes.end());
+        sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        long long classJobs = sorted.size() > static_cast<size_t>(maxPriorityClasses)
+                                  ? (jobs + maxPriorityClasses - 1) / maxPriorityClasses
+                                  : 1;
+        ClassTotals merged;
+        for (size_t i = 0; i < sorted.size(); i++) {
+            merged.add(sorted[i].second);
+            if (merged.jobs < classJobs && i + 1 < sorted.size()) {
+                continue;
+            }
+            PriorityClassStats stats;
+            stats.minPriority = merged.minPriority;
+            stats.maxPriority = merged.maxPriority;
+            stats.jobs = static_cast<int>(merged.jobs);
+            stats.avgWaitingTime = merged.waiting / merged.jobs;
+            stats.avgResponseTime = merged.response / merged.jobs;
+            stats.avgTurnaroundTime = merged.turnaround / merged.jobs;
+            stats.meanSlowdown = merged.slowdown / merged.jobs;
+            stats.maxSlowdown = merged.maxSlowdown;
+            stats.maxWaitingTime = merged.maxWaitingTime;
+            fairness.classes.push_back(stats);
+            merged = ClassTotals();
+        }
+    }
+
+private:
+    struct ClassTotals {
+        int minPriority = 0;
+        int maxPriority = INT_MIN;
+        long long jobs = 0;
+        double waiting = 0;
+        double response = 0;
+        double turnaround = 0;
+        double slowdown = 0;
+        double maxSlowdown = 0;
+        int maxWaitingTime = 0;
+
+        void add(const ClassTotals& other) {
+            minPriority = jobs == 0 ? other.minPriority : std::min(minPriority, other.minPriority);
+            maxPriority = std::max(maxPriority, other.maxPriority);
+            jobs += other.jobs;
+            waiting += other.waiting;
+            response += other.response;
+            turnaround += other.turnaround;
+            slowdown += other.slowdown;
+            maxSlowdown = std::max(maxSlowdown, other.maxSlowdown);
+            maxWaitingTime = std::max(maxWaitingTime, other.maxWaitingTime);
+        }
+    };
+
+    int starvationThreshold;
+    LatencyHistogram waiting;
+    LatencyHistogram response;
+    LatencyHistogram turnaround;
+    int starved = 0;
+    long long jobs = 0;
+    double slowdownSum = 0;
+    double slowdownSquares = 0;
+    double maxSlowdown = 0;
+    // Order-preserving key of the log-spaced range holding a priority
+    static int coarseKey(int priority) {
+        if (priority >= 0) {
+            return static_cast<int>(LatencyHistogram::bucketIndex(priority));
+        }
+        return -1 - static_cast<int>(LatencyHistogram::bucketIndex(-(priority + 1)));
+    }
+
+    void coarsen() {
+        unordered_map<int, ClassTotals> grouped;
+        for (const auto& [priority, totals] : classes) {
+            grouped[coarseKey(priority)].add(totals);
+        }
+        classes = std::move(grouped);
+        coarse = true;
+    }
+
+    // Keyed by priority, or by coarseKey() once coarse
+    unordered_map<int, ClassTotals> classes;
+    bool coarse = false;
+    ClassTotals* current = nullptr;
+    int currentPriority = 0;
+};
+
+// Summarizes per-job lateness; reorders the input
+DeadlineStats deadlineStats(vector<int>& lateness) {
+    DeadlineStats stats;
+    stats.jobs = static_cast<int>(lateness.size());
+    if (lateness.empty()) {
+        return stats;
+    }
+    double total = 0;
+    for (int l : lateness) {
+        total += l;
+        stats.missed += l > 0 ? 1 : 0;
+    }
+    stats.meanLateness = total / lateness.size();
+    stats.minLateness = *min_element(lateness.begin(), lateness.end());
+    stats.maxLateness = *max_element(lateness.begin(), lateness.end());
+    stats.maxTardiness = std::max(0, stats.maxLateness);
+    stats.p50Lateness = static_cast<int>(percentile(lateness, 0.5));
+    stats.p90Lateness = static_cast<int>(percentile(lateness, 0.9));
+    stats.p99Lateness = static_cast<int>(percentile(lateness, 0.99));
+    return stats;
+}
+
+ShareStats shareStats(const vector<ProcessMetrics>& metrics) {
+    ShareStats stats;
+    double totalError = 0;
+    for (const auto& pm : metrics) {
+        if (pm.tickets == 0) {
+            continue;
+        }
+        stats.maxLag = std::max(stats.maxLag, pm.maxLag);
+        // A job entitled to no service has no relative error
+        if (pm.idealService <= 0) {
+            continue;
+        }
+        double error = std::abs(pm.burstTime - pm.idealService) / pm.idealService;
+        stats.jobs++;
+        totalError += error;
+        stats.maxAbsShareError = std::max(stats.maxAbsShareError, error);
+    }
+    if (stats.jobs > 0) {
+        stats.meanAbsShareError = totalError / stats.jobs;
+    }
+    return stats;
+}
+
+// Dispatch bookkeeping of the single-burst engines: every run after the
+// first resumes the job's only burst, so it follows a preemption
+void countDispatch(Process& p) {
+    p.preemptions += p.dispatches > 0 ? 1 : 0;
+    p.dispatches++;
+}
+
+// Fills the gaps of a Gantt chart with idle segments, per CPU up to
+// `makespan`. Entries of each CPU must come in time order, as the engines
+// emit them; idle segments go right before the entry that ends the gap.
+void addIdleSegments(vector<GanttEntry>& ganttChart, int cpuCount, int makespan) {
+    vector<int> busyUntil(cpuCount, 0);
+    vector<GanttEntry> filled;
+    filled.reserve(ganttChart.size() * 2 + cpuCount);
+    for (const auto& entry : ganttChart) {
+        int& until = busyUntil[entry.cpu];
+        if (entry.startTime > until) {
+            filled.push_back({idleProcessId, until, entry.startTime, entry.cpu});
+        }
+        until = std::max(until, entry.endTime);
+        filled.push_back(entry);
+    }
+    for (int c = 0; c < cpuCount; c++) {
+        if (busyUntil[c] < makespan) {
+            filled.push_back({idleProcessId, busyUntil[c], makespan, c});
+        }
+    }
+    ganttChart = std::move(filled);
 }
 
 AlgorithmResult calculateMetrics(const string& name,
                                const vector<Process>& processes,
-                               const vector<GanttEntry>& ganttChart) {
+                               vector<GanttEntry> ganttChart,
+                               const SimOptions& options = SimOptions(),
+                               int cpuCount = 1) {
     AlgorithmResult result;
     result.name = name;
-    result.ganttChart = ganttChart;
+    result.contextSwitches = ganttChart.empty() ? 0 : static_cast<int>(ganttChart.size()) - 1;
+    if (options.recordGantt) {
+        result.ganttChart = std::move(ganttChart);
+    }
 
     double totalTurnaroundTime = 0;
     double totalWaitingTime = 0;
     double totalResponseTime = 0;
     double totalCompletionTime = 0;
+    double totalBurstTime = 0;
+    int totalTime = 0;
+    CompletionRecorder recorder(options.starvationThreshold);
+    vector<int> lateness;
 
+    if (options.recordProcesses) {
+        result.processMetrics.reserve(processes.size());
+    }
     for (const auto& p : processes) {
+        totalTurnaroundTime += p.turnaroundTime;
+        totalWaitingTime += p.waitingTime;
+        totalResponseTime += p.responseTime;
+        totalCompletionTime += p.completionTime;
+        totalBurstTime += p.burstTime;
+        totalTime = max(totalTime, p.completionTime);
+        result.preemptions += p.preemptions;
+        recorder.record(p.waitingTime, p.responseTime, p.turnaroundTime, p.burstTime, p.priority);
+        if (p.deadline != noDeadline) {
+            lateness.push_back(p.completionTime - p.deadline);
+        }
+
+        if (!options.recordProcesses) {
+            continue;
+        }
         ProcessMetrics pm;
         pm.id = p.id;
         pm.arrivalTime = p.arrivalTime;
@@ -92,29 +703,36 @@ AlgorithmResult calculateMetrics(const string& name,
         pm.turnaroundTime = p.turnaroundTime;
         pm.waitingTime = p.waitingTime;
         pm.responseTime = p.responseTime;
+        pm.deadline = p.deadline;
+        pm.dispatches = p.dispatches;
+        pm.preemptions = p.preemptions;
         result.processMetrics.push_back(pm);
-
-        totalTurnaroundTime += p.turnaroundTime;
-        totalWaitingTime += p.waitingTime;
-        totalResponseTime += p.responseTime;
-        totalCompletionTime += p.completionTime;
     }
 
-    int totalTime = ganttChart.empty() ? 0 : ganttChart.back().endTime;
-
     result.avgTurnaroundTime = totalTurnaroundTime / processes.size();
     result.avgWaitingTime = totalWaitingTime / processes.size();
     result.avgResponseTime = totalResponseTime / processes.size();
     result.avgCompletionTime = totalCompletionTime / processes.size();
     result.throughput = static_cast<double>(processes.size()) / totalTime;
+    result.makespan = totalTime;
+    result.cpuUtilization = totalTime > 0 ? 100.0 * totalBurstTime / (static_cast<double>(totalTime) * cpuCount) : 0;
+    result.idleTime = static_cast<long long>(totalTime) * cpuCount - static_cast<long long>(totalBurstTime);
+    if (options.timelineBucket > 0) {
+        result.timeline = singleCpuTimeline(processes, totalTime, options);
+    }
+    if (options.recordGantt) {
+        addIdleSegments(result.ganttChart, cpuCount, totalTime);
+    }
+    recorder.finish(result);
+    result.deadlines = deadlineStats(lateness);
 
     return result;
 }
 
 // (FCFS) Algorithm
-AlgorithmResult fcfs(vector<Process> processes) {
+AlgorithmResult fcfs(vector<Process> processes, const SimOptions& options = SimOptions()) {
     vector<GanttEntry> ganttChart;
-    sort(processes.begin(), processes.end(), [](const Process& a, const Process& b) {
+    stable_sort(processes.begin(), processes.end(), [](const Process& a, const Process& b) {
         return a.arrivalTime < b.arrivalTime;
     });
 
@@ -131,18 +749,139 @@ AlgorithmResult fcfs(vector<Process> processes) {
         p.responseTime = currentTime - p.arrivalTime;
         currentTime += p.burstTime;
         entry.endTime = currentTime;
-        ganttChart.push_back(entry);
+        if (options.recordGantt) {
+            ganttChart.push_back(entry);
+        }
+        countDispatch(p);
 
         p.completionTime = currentTime;
         p.turnaroundTime = p.completionTime - p.arrivalTime;
         p.waitingTime = p.turnaroundTime - p.burstTime;
     }
 
-    return calculateMetrics("FCFS", processes, ganttChart);
+    AlgorithmResult result = calculateMetrics("FCFS", processes, std::move(ganttChart), options);
+    result.contextSwitches = processes.empty() ? 0 : static_cast<int>(processes.size()) - 1;
+    return result;
+}
+
+// Batched FCFS kernel: each SIMD lane advances a different workload through
+// the same scan as fcfs(), so a group of fcfsLanes workloads costs one pass
+// over the longest of them. Uses GCC/Clang vector extensions, which lower to
+// SSE/AVX on x86 and NEON on ARM. Only aggregate metrics are produced; callers
+// that need Gantt charts, per-process rows or timelines use fcfs() directly.
+// Every other field must come out exactly as fcfs() computes it, since batch
+// cells mix both paths.
+constexpr size_t fcfsLanes = 8;
+typedef int32_t FcfsLaneInts __attribute__((vector_size(fcfsLanes * sizeof(int32_t))));
+typedef int64_t FcfsLaneSums __attribute__((vector_size(fcfsLanes * sizeof(int64_t))));
+
+vector<AlgorithmResult> fcfsBatch(const vector<const vector<Process>*>& workloads,
+                                  const SimOptions& options = SimOptions()) {
+    vector<AlgorithmResult> results(workloads.size());
+    vector<FcfsLaneInts> arrivals, bursts, priorities, deadlines, valid, responses;
+    vector<int> order;
+    vector<int> lateness;
+
+    for (size_t group = 0; group < workloads.size(); group += fcfsLanes) {
+        size_t lanes = std::min(fcfsLanes, workloads.size() - group);
+
+        // Transpose the group into step-major arrays: step k holds the k-th
+        // arrival-ordered process of every lane; short lanes are zero-padded
+        size_t steps = 0;
+        for (size_t lane = 0; lane < lanes; lane++) {
+            steps = std::max(steps, workloads[group + lane]->size());
+        }
+        arrivals.assign(steps, FcfsLaneInts{});
+        bursts.assign(steps, FcfsLaneInts{});
+        priorities.assign(steps, FcfsLaneInts{});
+        deadlines.assign(steps, FcfsLaneInts{});
+        valid.assign(steps, FcfsLaneInts{});
+        responses.resize(steps);
+        for (size_t lane = 0; lane < lanes; lane++) {
+            const vector<Process>& processes = *workloads[group + lane];
+            order.resize(processes.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                order[i] = static_cast<int>(i);
+            }
+            // Tiny workloads: a stable insertion sort avoids stable_sort's buffer allocation
+            auto byArrival = [&](int a, int b) {
+                return processes[a].arrivalTime < processes[b].arrivalTime;
+            };
+            if (order.size() > 32) {
+                stable_sort(order.begin(), order.end(), byArrival);
+            } else {
+                for (size_t i = 1; i < order.size(); i++) {
+                    int current = order[i];
+                    size_t j = i;
+                    for (; j > 0 && byArrival(current, order[j - 1]); j--) {
+                        order[j] = order[j - 1];
+                    }
+                    order[j] = current;
+                }
+            }
+            for (size_t k = 0; k < order.size(); k++) {
+                arrivals[k][lane] = processes[order[k]].arrivalTime;
+                bursts[k][lane] = processes[order[k]].burstTime;
+                priorities[k][lane] = processes[order[k]].priority;
+                deadlines[k][lane] = processes[order[k]].deadline;
+                valid[k][lane] = -1;
+            }
+        }
+
+        // Padding steps have zero arrival and burst, so they never move time;
+        // the valid mask keeps them out of the sums
+        FcfsLaneInts currentTime = {};
+        FcfsLaneSums totalResponse = {};
+        FcfsLaneSums totalCompletion = {};
+        FcfsLaneSums totalArrival = {};
+        for (size_t k = 0; k < steps; k++) {
+            FcfsLaneInts later = currentTime < arrivals[k];
+            currentTime = (arrivals[k] & later) | (currentTime & ~later);
+            FcfsLaneInts response = (currentTime - arrivals[k]) & valid[k];
+            currentTime += bursts[k];
+
+            responses[k] = response;
+            totalResponse += __builtin_convertvector(response, FcfsLaneSums);
+            totalCompletion += __builtin_convertvector(currentTime & valid[k], FcfsLaneSums);
+            totalArrival += __builtin_convertvector(arrivals[k] & valid[k], FcfsLaneSums);
+        }
+
+        // Same aggregates as calculateMetrics(); FCFS waiting equals response
+        for (size_t lane = 0; lane < lanes; lane++) {
+            size_t count = workloads[group + lane]->size();
+            AlgorithmResult& result = results[group + lane];
+            result.name = "FCFS";
+            result.avgTurnaroundTime = static_cast<double>(totalCompletion[lane] - totalArrival[lane]) / count;
+            result.avgWaitingTime = static_cast<double>(totalResponse[lane]) / count;
+            result.avgResponseTime = static_cast<double>(totalResponse[lane]) / count;
+            result.avgCompletionTime = static_cast<double>(totalCompletion[lane]) / count;
+            result.throughput = static_cast<double>(count) / currentTime[lane];
+            result.makespan = currentTime[lane];
+            double totalBurst = static_cast<double>(totalCompletion[lane] - totalArrival[lane] - totalResponse[lane]);
+            result.cpuUtilization = currentTime[lane] > 0 ? 100.0 * totalBurst / currentTime[lane] : 0;
+            result.idleTime = currentTime[lane] - static_cast<long long>(totalBurst);
+            result.contextSwitches = count == 0 ? 0 : static_cast<int>(count) - 1;
+
+            CompletionRecorder recorder(options.starvationThreshold);
+            lateness.clear();
+            for (size_t k = 0; k < count; k++) {
+                int response = responses[k][lane];
+                recorder.record(response, response, response + bursts[k][lane], bursts[k][lane],
+                                priorities[k][lane]);
+                if (deadlines[k][lane] != noDeadline) {
+                    lateness.push_back(arrivals[k][lane] + response + bursts[k][lane] - deadlines[k][lane]);
+                }
+            }
+            recorder.finish(result);
+            result.deadlines = deadlineStats(lateness);
+        }
+    }
+
+    return results;
 }
 
 // (SJF) Algorithm
-AlgorithmResult sjf(std::vector<Process> processes) {
+AlgorithmResult sjf(std::vector<Process> processes, const SimOptions& options = SimOptions()) {
     vector<GanttEntry> ganttChart;
     vector<Process*> remainingProcesses;
 
@@ -167,17 +906,22 @@ AlgorithmResult sjf(std::vector<Process> processes) {
         
         currentTime += p->burstTime;
         entry.endTime = currentTime;
-        ganttChart.push_back(entry);
+        if (options.recordGantt) {
+            ganttChart.push_back(entry);
+        }
+        countDispatch(*p);
 
         p->completionTime = currentTime;
         p->turnaroundTime = p->completionTime;
         p->waitingTime = p->turnaroundTime - p->burstTime;
     }
 
-    return calculateMetrics("SJF", processes, ganttChart);
+    AlgorithmResult result = calculateMetrics("SJF", processes, std::move(ganttChart), options);
+    result.contextSwitches = processes.empty() ? 0 : static_cast<int>(processes.size()) - 1;
+    return result;
 }
 
-AlgorithmResult srtn(vector<Process> processes) {
+AlgorithmResult srtn(vector<Process> processes, const SimOptions& options = SimOptions()) {
     vector<GanttEntry> ganttChart;
     vector<Process*> remainingProcesses;
 
@@ -185,12 +929,14 @@ AlgorithmResult srtn(vector<Process> processes) {
         remainingProcesses.push_back(&p);
     }
 
-    std::sort(remainingProcesses.begin(), remainingProcesses.end(), [](const Process* a, const Process* b) {
+    std::stable_sort(remainingProcesses.begin(), remainingProcesses.end(), [](const Process* a, const Process* b) {
         return a->arrivalTime < b->arrivalTime;
     });
 
     int currentTime = 0;
     Process* currentProcess = nullptr;
+    int lastProcessId = -1;
+    int runs = 0;
 
     vector<pair<Process*, int>> remainingBurstTimes;
     for (auto* p : remainingProcesses) {
@@ -226,17 +972,21 @@ AlgorithmResult srtn(vector<Process> processes) {
         Process* selectedProcess = it->first;
 
         // Create a new gantt entry or extend the last one if it's the same process
-        if (!ganttChart.empty() && ganttChart.back().processId == selectedProcess->id) {
-            ganttChart.back().endTime = currentTime + 1;
-        } else {
-            if (!ganttChart.empty()) {
-                ganttChart.back().endTime = currentTime;
+        if (lastProcessId == selectedProcess->id) {
+            if (options.recordGantt) {
+                ganttChart.back().endTime = currentTime + 1;
             }
+        } else {
             GanttEntry entry;
             entry.processId = selectedProcess->id;
             entry.startTime = currentTime;
             entry.endTime = currentTime + 1;
-            ganttChart.push_back(entry);
+            if (options.recordGantt) {
+                ganttChart.push_back(entry);
+            }
+            lastProcessId = selectedProcess->id;
+            runs++;
+            countDispatch(*selectedProcess);
 
             if (!selectedProcess->started) {
                 selectedProcess->responseTime = currentTime - selectedProcess->arrivalTime;
@@ -275,326 +1025,4560 @@ AlgorithmResult srtn(vector<Process> processes) {
         }
     }
 
-    return calculateMetrics("SRTN", processes, mergedGanttChart);
+    AlgorithmResult result = calculateMetrics("SRTN", processes, std::move(mergedGanttChart), options);
+    result.contextSwitches = runs == 0 ? 0 : runs - 1;
+    return result;
 }
 
 // Round Robin (RR) Algorithm
-AlgorithmResult roundRobin(std::vector<Process> processes, int timeQuantum) {
+// Event-driven: arrivals are admitted from an arrival-ordered index as time
+// advances, so each slice costs O(1) instead of rescanning every process.
+AlgorithmResult roundRobin(std::vector<Process> processes, int timeQuantum,
+                           const SimOptions& options = SimOptions()) {
     vector<GanttEntry> ganttChart;
-    std::deque<Process*> readyQueue;
-    std::vector<Process*> remainingProcesses;
+    std::deque<int> readyQueue;
+    std::vector<int> arrivalOrder(processes.size());
+    std::vector<int> remainingBurst(processes.size());
 
-    for (auto& p : processes) {
+    for (size_t i = 0; i < processes.size(); i++) {
+        Process& p = processes[i];
         p.completionTime = 0;
         p.turnaroundTime = 0;
         p.waitingTime = 0;
         p.responseTime = -1;
         p.started = false;
-        remainingProcesses.push_back(&p);
+        arrivalOrder[i] = static_cast<int>(i);
+        remainingBurst[i] = p.burstTime;
     }
 
-    std::sort(remainingProcesses.begin(), remainingProcesses.end(), [](const Process* a, const Process* b) {
-        return a->arrivalTime < b->arrivalTime;
+    std::stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
     });
 
-    std::vector<std::pair<Process*, int>> remainingBurstTimes;
-    for (auto* p : remainingProcesses) {
-        remainingBurstTimes.push_back({p, p->burstTime});
-    }
+    size_t nextArrival = 0;
+    auto admitArrivals = [&](int time) {
+        while (nextArrival < arrivalOrder.size() && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            readyQueue.push_back(arrivalOrder[nextArrival++]);
+        }
+    };
 
     int currentTime = 0;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    size_t completed = 0;
 
-    // Add processes that arrive at time 0
-    for (auto& pair : remainingBurstTimes) {
-        if (pair.first->arrivalTime == 0) {
-            readyQueue.push_back(pair.first);
-        }
-    }
-
-    while (!readyQueue.empty() || !remainingBurstTimes.empty()) {
-        // Check for new arrivals
-        for (auto it = remainingBurstTimes.begin(); it != remainingBurstTimes.end();) {
-            if (it->second > 0 && it->first->arrivalTime <= currentTime &&
-                std::find(readyQueue.begin(), readyQueue.end(), it->first) == readyQueue.end()) {
-                readyQueue.push_back(it->first);
-            }
-            if (it->second <= 0) {
-                it = remainingBurstTimes.erase(it);
-            } else {
-                ++it;
-            }
-        }
+    while (completed < processes.size()) {
+        admitArrivals(currentTime);
 
         if (readyQueue.empty()) {
-            // Find next arrival time
-            int nextArrival = INT_MAX;
-            for (const auto& pair : remainingBurstTimes) {
-                if (pair.first->arrivalTime < nextArrival) {
-                    nextArrival = pair.first->arrivalTime;
-                }
-            }
-            currentTime = nextArrival;
+            // Fast-forward to the next arrival
+            currentTime = std::max(currentTime, processes[arrivalOrder[nextArrival]].arrivalTime);
             continue;
         }
 
-        Process* currentProcess = readyQueue.front();
+        int index = readyQueue.front();
         readyQueue.pop_front();
+        Process* currentProcess = &processes[index];
 
         if (!currentProcess->started) {
             currentProcess->responseTime = currentTime - currentProcess->arrivalTime;
             currentProcess->started = true;
         }
 
-        // Find remaining burst time
-        int remainingBurst = 0;
-        for (auto& pair : remainingBurstTimes) {
-            if (pair.first == currentProcess) {
-                remainingBurst = pair.second;
-                break;
+        int executionTime = std::min(timeQuantum, remainingBurst[index]);
+
+        if (currentProcess->id != lastProcessId) {
+            if (lastProcessId != -1) {
+                contextSwitches++;
             }
+            lastProcessId = currentProcess->id;
+            countDispatch(*currentProcess);
+            if (options.recordGantt) {
+                ganttChart.push_back({currentProcess->id, currentTime, currentTime + executionTime});
+            }
+        } else if (options.recordGantt) {
+            // Same process again: extend its entry instead of splitting it
+            ganttChart.back().endTime = currentTime + executionTime;
         }
 
-        int executionTime = std::min(timeQuantum, remainingBurst);
-
-        GanttEntry entry;
-        entry.processId = currentProcess->id;
-        entry.startTime = currentTime;
-        entry.endTime = currentTime + executionTime;
-        ganttChart.push_back(entry);
-
         currentTime += executionTime;
+        remainingBurst[index] -= executionTime;
 
-        // Update remaining burst time
-        for (auto& pair : remainingBurstTimes) {
-            if (pair.first == currentProcess) {
-                pair.second -= executionTime;
-
-                if (pair.second <= 0) {
-                    // Process completed
-                    currentProcess->completionTime = currentTime;
-                    currentProcess->turnaroundTime = currentProcess->completionTime - currentProcess->arrivalTime;
-                    currentProcess->waitingTime = currentProcess->turnaroundTime - currentProcess->burstTime;
-                } else {
-                    // Process still has remaining time, add back to ready queue
-                    // Check for new arrivals before re-adding the current process
-                    for (auto it = remainingBurstTimes.begin(); it != remainingBurstTimes.end(); ++it) {
-                        if (it->first != currentProcess && it->second > 0 &&
-                            it->first->arrivalTime <= currentTime &&
-                            std::find(readyQueue.begin(), readyQueue.end(), it->first) == readyQueue.end()) {
-                            readyQueue.push_back(it->first);
-                        }
-                    }
-                    readyQueue.push_back(currentProcess);
-                }
-                break;
-            }
-        }
-    }
-
-    // Clean up gantt chart by merging consecutive entries with same process
-    std::vector<GanttEntry> mergedGanttChart;
-    for (const auto& entry : ganttChart) {
-        if (mergedGanttChart.empty() || mergedGanttChart.back().processId != entry.processId) {
-            mergedGanttChart.push_back(entry);
+        if (remainingBurst[index] <= 0) {
+            // Process completed
+            currentProcess->completionTime = currentTime;
+            currentProcess->turnaroundTime = currentProcess->completionTime - currentProcess->arrivalTime;
+            currentProcess->waitingTime = currentProcess->turnaroundTime - currentProcess->burstTime;
+            completed++;
         } else {
-            mergedGanttChart.back().endTime = entry.endTime;
+            // Arrivals during the slice queue up ahead of the preempted process
+            admitArrivals(currentTime);
+            readyQueue.push_back(index);
         }
     }
 
-    return calculateMetrics("Round Robin (TQ=" + std::to_string(timeQuantum) + ")", processes, mergedGanttChart);
+    AlgorithmResult result = calculateMetrics("Round Robin (TQ=" + std::to_string(timeQuantum) + ")",
+                                              processes, std::move(ganttChart), options);
+    result.contextSwitches = contextSwitches;
+    return result;
 }
 
-// Priority (Non-Preemptive) Algorithm
-AlgorithmResult priorityNonPreemptive(std::vector<Process> processes) {
-    std::vector<GanttEntry> ganttChart;
-    std::vector<Process*> remainingProcesses;
+// Multilevel Feedback Queue configuration: quanta[l] is the CPU allotment a
+// job may use at level l before it is demoted; every boostInterval time
+// units all jobs return to the top level (0 disables the boost)
+struct MlfqConfig {
+    vector<int> quanta = {2, 4, 8};
+    int boostInterval = 100;
+};
 
-    for (auto& p : processes) {
-        remainingProcesses.push_back(&p);
+// Multilevel Feedback Queue (MLFQ) Algorithm
+// Levels are intrusive FIFO lists threaded through a next-index array, and a
+// bitmap of non-empty levels gives the highest ready level with one
+// count-trailing-zeros, so dispatch is O(1) and never allocates. A job that
+// uses up its level's allotment is demoted; arrivals preempt lower levels.
+// The periodic boost splices every level onto the top one in O(levels) and
+// resets allotments lazily through a boost epoch.
+AlgorithmResult mlfq(vector<Process> processes, const MlfqConfig& config,
+                     const SimOptions& options = SimOptions()) {
+    const int levels = static_cast<int>(config.quanta.size());
+    size_t n = processes.size();
+
+    vector<int> arrivalOrder(n);
+    vector<int> remainingBurst(n);
+    vector<int> usedAllotment(n, 0);
+    vector<int> boostEpoch(n, 0);
+    vector<int> nextInLevel(n, -1);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].started = false;
+        arrivalOrder[i] = static_cast<int>(i);
+        remainingBurst[i] = processes[i].burstTime;
     }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
 
-    int currentTime = 0;
-    while (!remainingProcesses.empty()) {
-        std::vector<Process*> availableProcesses;
-        for (auto* p : remainingProcesses) {
-            if (p->arrivalTime <= currentTime) {
-                availableProcesses.push_back(p);
-            }
+    vector<int> head(levels, -1);
+    vector<int> tail(levels, -1);
+    uint64_t nonEmpty = 0;
+
+    auto pushBack = [&](int level, int index) {
+        nextInLevel[index] = -1;
+        if (tail[level] < 0) {
+            head[level] = index;
+        } else {
+            nextInLevel[tail[level]] = index;
+        }
+        tail[level] = index;
+        nonEmpty |= uint64_t(1) << level;
+    };
+    auto popFront = [&](int level) {
+        int index = head[level];
+        head[level] = nextInLevel[index];
+        if (head[level] < 0) {
+            tail[level] = -1;
+            nonEmpty &= ~(uint64_t(1) << level);
         }
+        return index;
+    };
 
-        if (availableProcesses.empty()) {
-            // Fast-forward to the next process arrival
-            int nextArrival = INT_MAX;
-            for (auto* p : remainingProcesses) {
-                if (p->arrivalTime < nextArrival) {
-                    nextArrival = p->arrivalTime;
-                }
+    int epoch = 0;
+    long long nextBoost = config.boostInterval > 0 ? config.boostInterval : LLONG_MAX;
+    auto boost = [&]() {
+        for (int level = 1; level < levels; level++) {
+            if (head[level] < 0) {
+                continue;
             }
-            currentTime = nextArrival;
-            continue;
+            if (tail[0] < 0) {
+                head[0] = head[level];
+            } else {
+                nextInLevel[tail[0]] = head[level];
+            }
+            tail[0] = tail[level];
+            head[level] = tail[level] = -1;
         }
+        if (nonEmpty) {
+            nonEmpty = 1;
+        }
+        epoch++;
+    };
 
-        // Find the process with highest priority (lower number = higher priority)
-        auto it = std::min_element(availableProcesses.begin(), availableProcesses.end(),
-                                   [](const Process* a, const Process* b) {
-                                       return a->priority < b->priority;
-                                   });
-        Process* selectedProcess = *it;
-
-        GanttEntry entry;
-        entry.processId = selectedProcess->id;
-        entry.startTime = currentTime;
+    size_t nextArrival = 0;
+    auto admitArrivals = [&](int time) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            int index = arrivalOrder[nextArrival++];
+            boostEpoch[index] = epoch;
+            pushBack(0, index);
+        }
+    };
 
-        selectedProcess->responseTime = currentTime - selectedProcess->arrivalTime;
-        currentTime += selectedProcess->burstTime;
-        entry.endTime = currentTime;
-        ganttChart.push_back(entry);
+    vector<GanttEntry> ganttChart;
+    int currentTime = 0;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    size_t completed = 0;
 
-        selectedProcess->completionTime = currentTime;
-        selectedProcess->turnaroundTime = selectedProcess->completionTime - selectedProcess->arrivalTime;
-        selectedProcess->waitingTime = selectedProcess->turnaroundTime - selectedProcess->burstTime;
+    while (completed < n) {
+        admitArrivals(currentTime);
 
-        // Remove the selected process from remaining processes
-        remainingProcesses.erase(std::remove(remainingProcesses.begin(), remainingProcesses.end(), selectedProcess),
-                                 remainingProcesses.end());
-    }
+        // Boosts take effect at the first dispatch at or after each interval
+        if (currentTime >= nextBoost) {
+            boost();
+            nextBoost = (currentTime / config.boostInterval + 1) * static_cast<long long>(config.boostInterval);
+        }
 
-    return calculateMetrics("Priority (Non-Preemptive)", processes, ganttChart);
-}
+        if (!nonEmpty) {
+            currentTime = std::max(currentTime, processes[arrivalOrder[nextArrival]].arrivalTime);
+            continue;
+        }
+
+        int level = __builtin_ctzll(nonEmpty);
+        int index = popFront(level);
+        Process& p = processes[index];
+        if (boostEpoch[index] != epoch) {
+            boostEpoch[index] = epoch;
+            usedAllotment[index] = 0;
+        }
+        if (!p.started) {
+            p.responseTime = currentTime - p.arrivalTime;
+            p.started = true;
+        }
+
+        // Run until the allotment is used up, the job finishes, or (below the
+        // top level) the next arrival preempts it
+        int sliceEnd = currentTime + std::min(config.quanta[level] - usedAllotment[index], remainingBurst[index]);
+        if (level > 0 && nextArrival < n) {
+            sliceEnd = std::min(sliceEnd, processes[arrivalOrder[nextArrival]].arrivalTime);
+        }
+
+        if (p.id != lastProcessId) {
+            if (lastProcessId != -1) {
+                contextSwitches++;
+            }
+            lastProcessId = p.id;
+            countDispatch(p);
+            if (options.recordGantt) {
+                ganttChart.push_back({p.id, currentTime, sliceEnd});
+            }
+        } else if (options.recordGantt) {
+            ganttChart.back().endTime = sliceEnd;
+        }
+
+        int ran = sliceEnd - currentTime;
+        currentTime = sliceEnd;
+        remainingBurst[index] -= ran;
+        usedAllotment[index] += ran;
+
+        if (remainingBurst[index] == 0) {
+            p.completionTime = currentTime;
+            p.turnaroundTime = p.completionTime - p.arrivalTime;
+            p.waitingTime = p.turnaroundTime - p.burstTime;
+            completed++;
+            continue;
+        }
+
+        admitArrivals(currentTime);
+        if (usedAllotment[index] >= config.quanta[level]) {
+            // Allotment used up: demote (the bottom level is plain round robin)
+            level = std::min(level + 1, levels - 1);
+            usedAllotment[index] = 0;
+        }
+        pushBack(level, index);
+    }
+
+    AlgorithmResult result = calculateMetrics("MLFQ (" + to_string(levels) + " levels)", processes,
+                                              std::move(ganttChart), options);
+    result.contextSwitches = contextSwitches;
+    return result;
+}
+
+// Completely Fair Scheduler configuration (time units of the simulation).
+// Each runnable job gets a share of targetLatency proportional to its
+// weight; with many jobs the period stretches to minGranularity per job.
+struct CfsConfig {
+    int targetLatency = 24;
+    int minGranularity = 3;
+};
+
+// Linux sched_prio_to_weight: weight for nice -20..19 (nice 0 = 1024)
+const int cfsNiceWeights[40] = {
+    88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+    9548,  7620,  6100,  4904,  3906,  3121,  2501,  1991,  1586,  1277,
+    1024,  820,   655,   526,   423,   335,   272,   215,   172,   137,
+    110,   87,    70,    56,    45,    36,    29,    23,    18,    15,
+};
+
+// Priorities 1..40 map onto nice -20..19 (lower number = higher priority),
+// values outside that range are clamped
+int cfsWeight(int priority) {
+    return cfsNiceWeights[std::min(std::max(priority, 1), 40) - 1];
+}
+
+// CFS-style fair scheduling Algorithm
+// Runnable jobs sit in an ordered tree keyed by weighted virtual runtime; the
+// leftmost job runs for its weighted share of the scheduling period and is
+// reinserted with its vruntime advanced by ran * 1024 / weight, so pick-next
+// and reinsertion are O(log n). New jobs start at the current min_vruntime.
+// Arrivals wait for the running slice to end (no wakeup preemption).
+AlgorithmResult cfs(vector<Process> processes, const CfsConfig& config,
+                    const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    vector<int> remainingBurst(n);
+    vector<long long> vruntime(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].started = false;
+        arrivalOrder[i] = static_cast<int>(i);
+        remainingBurst[i] = processes[i].burstTime;
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    // vruntime is kept with 10 extra fractional bits to limit rounding drift
+    const long long niceZeroWeight = 1024;
+    set<pair<long long, int>> runnable;
+    long long totalWeight = 0;
+    long long minVruntime = 0;
+
+    size_t nextArrival = 0;
+    auto admitArrivals = [&](int time) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            int index = arrivalOrder[nextArrival++];
+            vruntime[index] = minVruntime;
+            runnable.insert({vruntime[index], index});
+            totalWeight += cfsWeight(processes[index].priority);
+        }
+    };
+
+    vector<GanttEntry> ganttChart;
+    int currentTime = 0;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    size_t completed = 0;
+
+    while (completed < n) {
+        admitArrivals(currentTime);
+
+        if (runnable.empty()) {
+            currentTime = std::max(currentTime, processes[arrivalOrder[nextArrival]].arrivalTime);
+            continue;
+        }
+
+        int index = runnable.begin()->second;
+        runnable.erase(runnable.begin());
+        Process& p = processes[index];
+        long long weight = cfsWeight(p.priority);
+        if (!p.started) {
+            p.responseTime = currentTime - p.arrivalTime;
+            p.started = true;
+        }
+
+        // Slice: weighted share of the period, which grows with the run queue
+        long long running = static_cast<long long>(runnable.size()) + 1;
+        long long period = std::max<long long>(config.targetLatency, running * config.minGranularity);
+        long long slice = std::max<long long>(1, period * weight / totalWeight);
+        int ran = static_cast<int>(std::min<long long>(slice, remainingBurst[index]));
+
+        if (p.id != lastProcessId) {
+            if (lastProcessId != -1) {
+                contextSwitches++;
+            }
+            lastProcessId = p.id;
+            countDispatch(p);
+            if (options.recordGantt) {
+                ganttChart.push_back({p.id, currentTime, currentTime + ran});
+            }
+        } else if (options.recordGantt) {
+            ganttChart.back().endTime = currentTime + ran;
+        }
+
+        currentTime += ran;
+        remainingBurst[index] -= ran;
+        vruntime[index] += (static_cast<long long>(ran) * niceZeroWeight << 10) / weight;
+
+        if (remainingBurst[index] == 0) {
+            p.completionTime = currentTime;
+            p.turnaroundTime = p.completionTime - p.arrivalTime;
+            p.waitingTime = p.turnaroundTime - p.burstTime;
+            totalWeight -= weight;
+            completed++;
+        } else {
+            runnable.insert({vruntime[index], index});
+        }
+
+        // min_vruntime only moves forward, tracking the leftmost runnable job
+        if (!runnable.empty()) {
+            minVruntime = std::max(minVruntime, runnable.begin()->first);
+        }
+    }
+
+    AlgorithmResult result = calculateMetrics("CFS", processes, std::move(ganttChart), options);
+    result.contextSwitches = contextSwitches;
+    return result;
+}
+
+// Earliest Deadline First (EDF) Algorithm
+// Ready jobs sit in a min-heap on (deadline, arrival order); jobs without a
+// deadline sort after all others. The preemptive variant re-decides at every
+// arrival, the non-preemptive one runs each job to completion. Both are
+// event-driven: O(log n) per arrival and dispatch.
+AlgorithmResult edf(vector<Process> processes, bool preemptive, const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    vector<int> remainingBurst(n);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].started = false;
+        arrivalOrder[i] = static_cast<int>(i);
+        remainingBurst[i] = processes[i].burstTime;
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    // (deadline, arrival rank, index)
+    typedef tuple<int, int, int> ReadyJob;
+    priority_queue<ReadyJob, vector<ReadyJob>, greater<ReadyJob>> readyQueue;
+    vector<int> arrivalRank(n);
+
+    size_t nextArrival = 0;
+    auto admitArrivals = [&](int time) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            int index = arrivalOrder[nextArrival];
+            arrivalRank[index] = static_cast<int>(nextArrival++);
+            readyQueue.push({processes[index].deadline, arrivalRank[index], index});
+        }
+    };
+
+    vector<GanttEntry> ganttChart;
+    int currentTime = 0;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    size_t completed = 0;
+
+    while (completed < n) {
+        admitArrivals(currentTime);
+
+        if (readyQueue.empty()) {
+            currentTime = std::max(currentTime, processes[arrivalOrder[nextArrival]].arrivalTime);
+            continue;
+        }
+
+        int index = get<2>(readyQueue.top());
+        readyQueue.pop();
+        Process& p = processes[index];
+        if (!p.started) {
+            p.responseTime = currentTime - p.arrivalTime;
+            p.started = true;
+        }
+
+        // Preemptive: run until the next arrival, which may bring an earlier deadline
+        int sliceEnd = currentTime + remainingBurst[index];
+        if (preemptive && nextArrival < n) {
+            sliceEnd = std::min(sliceEnd, processes[arrivalOrder[nextArrival]].arrivalTime);
+        }
+
+        if (p.id != lastProcessId) {
+            if (lastProcessId != -1) {
+                contextSwitches++;
+            }
+            lastProcessId = p.id;
+            countDispatch(p);
+            if (options.recordGantt) {
+                ganttChart.push_back({p.id, currentTime, sliceEnd});
+            }
+        } else if (options.recordGantt) {
+            ganttChart.back().endTime = sliceEnd;
+        }
+
+        remainingBurst[index] -= sliceEnd - currentTime;
+        currentTime = sliceEnd;
+
+        if (remainingBurst[index] == 0) {
+            p.completionTime = currentTime;
+            p.turnaroundTime = p.completionTime - p.arrivalTime;
+            p.waitingTime = p.turnaroundTime - p.burstTime;
+            completed++;
+        } else {
+            readyQueue.push({p.deadline, arrivalRank[index], index});
+        }
+    }
+
+    AlgorithmResult result = calculateMetrics(preemptive ? "EDF (Preemptive)" : "EDF (Non-Preemptive)", processes,
+                                              std::move(ganttChart), options);
+    result.contextSwitches = contextSwitches;
+    return result;
+}
+
+// Fenwick tree over ticket counts: O(log n) updates and ticket lookups
+class TicketTree {
+public:
+    explicit TicketTree(size_t size) : tree(size + 1, 0) {
+        while (topBit * 2 <= size) {
+            topBit *= 2;
+        }
+    }
+
+    void add(size_t index, long long delta) {
+        total += delta;
+        for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1)) {
+            tree[i] += delta;
+        }
+    }
+
+    long long sum() const {
+        return total;
+    }
+
+    // Index holding the given ticket number (0 <= ticket < sum())
+    size_t find(long long ticket) const {
+        size_t position = 0;
+        for (size_t step = topBit; step > 0; step >>= 1) {
+            if (position + step < tree.size() && tree[position + step] <= ticket) {
+                position += step;
+                ticket -= tree[position];
+            }
+        }
+        return position;
+    }
+
+private:
+    vector<long long> tree;
+    long long total = 0;
+    size_t topBit = 1;
+};
+
+// Explicit tickets, or the CFS weight of the priority
+int shareTickets(const Process& p) {
+    return p.tickets > 0 ? p.tickets : cfsWeight(p.priority);
+}
+
+// Stride and Lottery Scheduling Algorithms
+// Both hand out timeQuantum-sized slices in proportion to tickets. Stride
+// runs the job with the smallest pass (advanced by ran / tickets) from a
+// heap; lottery draws a winning ticket with a seeded generator from a Fenwick
+// tree over ready jobs. Entitled service is tracked lazily: a global
+// accumulator integrates dt / (ready tickets), so a job's entitlement is its
+// tickets times the accumulator's growth since it arrived.
+AlgorithmResult proportionalShare(vector<Process> processes, int timeQuantum, bool lottery, uint64_t seed,
+                                  const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    vector<int> remainingBurst(n);
+    vector<long long> tickets(n);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].started = false;
+        arrivalOrder[i] = static_cast<int>(i);
+        remainingBurst[i] = processes[i].burstTime;
+        tickets[i] = shareTickets(processes[i]);
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    // Service per ticket handed out so far, and its value at each arrival
+    double entitlement = 0;
+    vector<double> entitlementAtArrival(n);
+    vector<double> idealService(n);
+    vector<double> maxLag(n, 0);
+    long long readyTickets = 0;
+    size_t readyCount = 0;
+
+    // Stride: passes are scaled by strideScale to stay integral
+    const long long strideScale = 1 << 20;
+    long long globalPass = 0;
+    vector<long long> pass(n);
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> passQueue;
+
+    // Lottery: tickets indexed by arrival rank
+    TicketTree ticketTree(lottery ? n : 0);
+    mt19937_64 rng(seed);
+
+    int currentTime = 0;
+    auto advanceTo = [&](int time) {
+        if (time > currentTime) {
+            entitlement += static_cast<double>(time - currentTime) / readyTickets;
+            globalPass += (time - currentTime) * strideScale / readyTickets;
+            currentTime = time;
+        }
+    };
+
+    size_t nextArrival = 0;
+    auto admit = [&]() {
+        int rank = static_cast<int>(nextArrival++);
+        int index = arrivalOrder[rank];
+        entitlementAtArrival[index] = entitlement;
+        readyTickets += tickets[index];
+        readyCount++;
+        if (lottery) {
+            ticketTree.add(rank, tickets[index]);
+        } else {
+            // Charged one quantum up front, as in the original stride scheduler
+            pass[index] = globalPass + timeQuantum * strideScale / tickets[index];
+            passQueue.push({pass[index], rank});
+        }
+    };
+    auto trackLag = [&](int index) {
+        double entitled = tickets[index] * (entitlement - entitlementAtArrival[index]);
+        double received = processes[index].burstTime - remainingBurst[index];
+        maxLag[index] = std::max(maxLag[index], std::abs(entitled - received));
+    };
+
+    vector<GanttEntry> ganttChart;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    size_t completed = 0;
+
+    while (completed < n) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= currentTime) {
+            admit();
+        }
+        if (readyCount == 0) {
+            // Idle: the next busy period starts from a fresh virtual time
+            currentTime = processes[arrivalOrder[nextArrival]].arrivalTime;
+            globalPass = 0;
+            continue;
+        }
+
+        int rank;
+        if (lottery) {
+            rank = static_cast<int>(ticketTree.find(static_cast<long long>(rng() % ticketTree.sum())));
+        } else {
+            rank = passQueue.top().second;
+            passQueue.pop();
+        }
+        int index = arrivalOrder[rank];
+        Process& p = processes[index];
+        if (!p.started) {
+            p.responseTime = currentTime - p.arrivalTime;
+            p.started = true;
+        }
+        // A waiting job's lag peaks right before it runs
+        trackLag(index);
+
+        int slice = std::min(timeQuantum, remainingBurst[index]);
+        int sliceEnd = currentTime + slice;
+        if (p.id != lastProcessId) {
+            if (lastProcessId != -1) {
+                contextSwitches++;
+            }
+            lastProcessId = p.id;
+            countDispatch(p);
+            if (options.recordGantt) {
+                ganttChart.push_back({p.id, currentTime, sliceEnd});
+            }
+        } else if (options.recordGantt) {
+            ganttChart.back().endTime = sliceEnd;
+        }
+
+        // Jobs arriving mid-slice start sharing from their arrival time
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime < sliceEnd) {
+            advanceTo(processes[arrivalOrder[nextArrival]].arrivalTime);
+            admit();
+        }
+        advanceTo(sliceEnd);
+        remainingBurst[index] -= slice;
+        // ...and a running job's lag bottoms out when its slice ends
+        trackLag(index);
+
+        if (remainingBurst[index] == 0) {
+            p.completionTime = currentTime;
+            p.turnaroundTime = p.completionTime - p.arrivalTime;
+            p.waitingTime = p.turnaroundTime - p.burstTime;
+            idealService[index] = tickets[index] * (entitlement - entitlementAtArrival[index]);
+            readyTickets -= tickets[index];
+            readyCount--;
+            completed++;
+            if (lottery) {
+                ticketTree.add(rank, -tickets[index]);
+            }
+        } else if (!lottery) {
+            pass[index] += slice * strideScale / tickets[index];
+            passQueue.push({pass[index], rank});
+        }
+    }
+
+    AlgorithmResult result = calculateMetrics(lottery ? "Lottery Scheduling" : "Stride Scheduling", processes,
+                                              std::move(ganttChart), options);
+    result.contextSwitches = contextSwitches;
+
+    vector<ProcessMetrics> shareRows;
+    vector<ProcessMetrics>& rows = options.recordProcesses ? result.processMetrics : shareRows;
+    rows.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        rows[i].burstTime = processes[i].burstTime;
+        rows[i].tickets = static_cast<int>(tickets[i]);
+        rows[i].idealService = idealService[i];
+        rows[i].maxLag = maxLag[i];
+    }
+    result.shares = shareStats(rows);
+    return result;
+}
+
+// Highest Response Ratio Next (HRRN) Algorithm
+// The response ratio (wait + burst) / burst grows linearly in time with slope
+// 1 / burst, so within one burst length the earliest arrival always leads.
+// Ready jobs are therefore kept as one FIFO per distinct burst, and the heads
+// compete in a kinetic tournament tree: each node remembers its winner and
+// the first time a challenger from below can overtake it. Dispatch times only
+// move forward, so a dispatch re-plays just the nodes whose certificate has
+// expired instead of rescanning the ready set. Ratios are compared by
+// cross-multiplication to stay exact; ties go to the earlier arrival.
+AlgorithmResult hrrn(vector<Process> processes, const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    for (size_t i = 0; i < n; i++) {
+        arrivalOrder[i] = static_cast<int>(i);
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    // One slot per distinct burst; jobs of a slot are stored in arrival order
+    vector<int> bursts;
+    bursts.reserve(n);
+    for (const auto& p : processes) {
+        bursts.push_back(p.burstTime);
+    }
+    sort(bursts.begin(), bursts.end());
+    bursts.erase(unique(bursts.begin(), bursts.end()), bursts.end());
+    size_t slots = bursts.size();
+
+    vector<int> slotOf(n);
+    vector<int> slotStart(slots + 1, 0);
+    for (size_t rank = 0; rank < n; rank++) {
+        int burst = processes[arrivalOrder[rank]].burstTime;
+        slotOf[rank] = static_cast<int>(lower_bound(bursts.begin(), bursts.end(), burst) - bursts.begin());
+        slotStart[slotOf[rank] + 1]++;
+    }
+    for (size_t s = 0; s < slots; s++) {
+        slotStart[s + 1] += slotStart[s];
+    }
+    vector<int> slotJobs(n);
+    vector<int> slotHead(slotStart.begin(), slotStart.end() - 1);
+    {
+        vector<int> fill = slotHead;
+        for (size_t rank = 0; rank < n; rank++) {
+            slotJobs[fill[slotOf[rank]]++] = static_cast<int>(rank);
+        }
+    }
+
+    auto arrivalOf = [&](int rank) {
+        return static_cast<long long>(processes[arrivalOrder[rank]].arrivalTime);
+    };
+    auto burstOf = [&](int rank) {
+        return static_cast<long long>(processes[arrivalOrder[rank]].burstTime);
+    };
+    // Whether job x has a strictly better claim than job y at time t
+    auto beats = [&](int x, int y, long long t) {
+        long long lhs = (t - arrivalOf(x)) * burstOf(y);
+        long long rhs = (t - arrivalOf(y)) * burstOf(x);
+        return lhs > rhs || (lhs == rhs && x < y);
+    };
+
+    // Tournament over slots: winner rank (-1 if empty) and certificate expiry
+    const long long never = LLONG_MAX;
+    size_t leaves = 1;
+    while (leaves < slots) {
+        leaves <<= 1;
+    }
+    vector<int> winner(2 * leaves, -1);
+    vector<long long> expiry(2 * leaves, never);
+
+    auto replay = [&](size_t node, long long t) {
+        int left = winner[2 * node];
+        int right = winner[2 * node + 1];
+        expiry[node] = std::min(expiry[2 * node], expiry[2 * node + 1]);
+        if (left < 0 || right < 0) {
+            winner[node] = left < 0 ? right : left;
+            return;
+        }
+        int win = beats(left, right, t) ? left : right;
+        int lose = win == left ? right : left;
+        winner[node] = win;
+        // A longer burst grows slower and never catches up
+        if (burstOf(lose) >= burstOf(win)) {
+            return;
+        }
+        long long overtake = (arrivalOf(lose) * burstOf(win) - arrivalOf(win) * burstOf(lose)) /
+                             (burstOf(win) - burstOf(lose));
+        overtake = std::max(overtake, t + 1);
+        while (!beats(lose, win, overtake)) {
+            overtake++;
+        }
+        expiry[node] = std::min(expiry[node], overtake);
+    };
+    auto setSlot = [&](int slot, int rank, long long t) {
+        size_t node = leaves + slot;
+        winner[node] = rank;
+        for (node >>= 1; node >= 1; node >>= 1) {
+            replay(node, t);
+        }
+    };
+    // Re-plays every match whose certificate expired by time t
+    auto refresh = [&](size_t node, long long t, auto& self) -> void {
+        if (expiry[node] > t) {
+            return;
+        }
+        self(2 * node, t, self);
+        self(2 * node + 1, t, self);
+        replay(node, t);
+    };
+
+    size_t nextArrival = 0;
+    auto admitArrivals = [&](int time) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            int rank = static_cast<int>(nextArrival++);
+            int slot = slotOf[rank];
+            if (slotJobs[slotHead[slot]] == rank) {
+                setSlot(slot, rank, time);
+            }
+        }
+    };
+
+    vector<GanttEntry> ganttChart;
+    int currentTime = 0;
+
+    for (size_t completed = 0; completed < n; completed++) {
+        admitArrivals(currentTime);
+        if (winner[1] < 0) {
+            currentTime = processes[arrivalOrder[nextArrival]].arrivalTime;
+            admitArrivals(currentTime);
+        }
+        refresh(1, currentTime, refresh);
+
+        int rank = winner[1];
+        int slot = slotOf[rank];
+        slotHead[slot]++;
+        int next = slotHead[slot] < slotStart[slot + 1] ? slotJobs[slotHead[slot]] : -1;
+        // The slot's next job joins once it has arrived
+        setSlot(slot, next >= 0 && next < static_cast<int>(nextArrival) ? next : -1, currentTime);
+
+        Process& p = processes[arrivalOrder[rank]];
+        p.responseTime = currentTime - p.arrivalTime;
+        countDispatch(p);
+        if (options.recordGantt) {
+            ganttChart.push_back({p.id, currentTime, currentTime + p.burstTime});
+        }
+        currentTime += p.burstTime;
+        p.completionTime = currentTime;
+        p.turnaroundTime = p.completionTime - p.arrivalTime;
+        p.waitingTime = p.turnaroundTime - p.burstTime;
+    }
+
+    AlgorithmResult result = calculateMetrics("HRRN", processes, std::move(ganttChart), options);
+    result.contextSwitches = n == 0 ? 0 : static_cast<int>(n) - 1;
+    return result;
+}
+
+// Priority aging: a job's effective priority improves (drops) by agingRate
+// per time unit spent waiting, and a running job keeps what it has reached.
+// A job queued at time q with effective priority e has, at time t,
+//   effective(t) = e - agingRate * (t - q).
+// All waiting jobs age at the same rate, so their order at any time equals
+// the order of the fixed key e + agingRate * q. Heaps on that key keep both
+// priority engines at O(log n) per event, with no per-tick updates.
+struct AgingKey {
+    double key;
+    int rank;
+
+    bool operator>(const AgingKey& other) const {
+        return key != other.key ? key > other.key : rank > other.rank;
+    }
+};
+
+// Priority (Non-Preemptive) Algorithm
+AlgorithmResult priorityNonPreemptive(std::vector<Process> processes, double agingRate = 0,
+                                      const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    for (size_t i = 0; i < n; i++) {
+        arrivalOrder[i] = static_cast<int>(i);
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    // Ties go to the earlier job in input order
+    priority_queue<AgingKey, vector<AgingKey>, greater<AgingKey>> readyQueue;
+    std::vector<GanttEntry> ganttChart;
+    int currentTime = 0;
+    size_t nextArrival = 0;
+
+    size_t completed = 0;
+
+    while (completed < n) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= currentTime) {
+            int index = arrivalOrder[nextArrival++];
+            readyQueue.push({processes[index].priority + agingRate * processes[index].arrivalTime, index});
+        }
+        if (readyQueue.empty()) {
+            // Fast-forward to the next process arrival
+            currentTime = processes[arrivalOrder[nextArrival]].arrivalTime;
+            continue;
+        }
+
+        Process& selectedProcess = processes[readyQueue.top().rank];
+        readyQueue.pop();
+
+        selectedProcess.responseTime = currentTime - selectedProcess.arrivalTime;
+        countDispatch(selectedProcess);
+        if (options.recordGantt) {
+            ganttChart.push_back({selectedProcess.id, currentTime, currentTime + selectedProcess.burstTime});
+        }
+        currentTime += selectedProcess.burstTime;
+
+        selectedProcess.completionTime = currentTime;
+        selectedProcess.turnaroundTime = selectedProcess.completionTime - selectedProcess.arrivalTime;
+        selectedProcess.waitingTime = selectedProcess.turnaroundTime - selectedProcess.burstTime;
+        completed++;
+    }
+
+    AlgorithmResult result = calculateMetrics("Priority (Non-Preemptive)", processes, std::move(ganttChart), options);
+    result.contextSwitches = n == 0 ? 0 : static_cast<int>(n) - 1;
+    return result;
+}
 
 // Priority (Preemptive) Algorithm
-AlgorithmResult priorityPreemptive(std::vector<Process> processes) {
+// Event-driven: the running job is re-checked at arrivals, at its completion
+// and, with aging, at the first time the best waiting job's effective
+// priority overtakes it.
+AlgorithmResult priorityPreemptive(std::vector<Process> processes, double agingRate = 0,
+                                   const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    vector<int> remainingBurst(n);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].started = false;
+        arrivalOrder[i] = static_cast<int>(i);
+        remainingBurst[i] = processes[i].burstTime;
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    // Ties go to the earlier arrival
+    priority_queue<AgingKey, vector<AgingKey>, greater<AgingKey>> readyQueue;
+    vector<double> effectivePriority(n);
+    for (size_t i = 0; i < n; i++) {
+        effectivePriority[i] = processes[i].priority;
+    }
+    auto enqueue = [&](int rank, int time) {
+        readyQueue.push({effectivePriority[arrivalOrder[rank]] + agingRate * time, rank});
+    };
+    auto dispatch = [&](int time) {
+        int rank = readyQueue.top().rank;
+        effectivePriority[arrivalOrder[rank]] = readyQueue.top().key - agingRate * time;
+        readyQueue.pop();
+        return rank;
+    };
+    // Whether the waiting job beats the running one at time t
+    auto beats = [&](const AgingKey& waiting, int runningRank, long long t) {
+        double effective = waiting.key - agingRate * t;
+        double running = effectivePriority[arrivalOrder[runningRank]];
+        return effective != running ? effective < running : waiting.rank < runningRank;
+    };
+
     std::vector<GanttEntry> ganttChart;
-    std::vector<Process*> remainingProcesses;
+    int currentTime = 0;
+    int running = -1;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    size_t nextArrival = 0;
+    size_t completed = 0;
+
+    while (completed < n) {
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= currentTime) {
+            enqueue(static_cast<int>(nextArrival), processes[arrivalOrder[nextArrival]].arrivalTime);
+            nextArrival++;
+        }
+
+        if (running < 0) {
+            if (readyQueue.empty()) {
+                // Fast-forward to the next process arrival
+                currentTime = processes[arrivalOrder[nextArrival]].arrivalTime;
+                continue;
+            }
+            running = dispatch(currentTime);
+        } else if (!readyQueue.empty() && beats(readyQueue.top(), running, currentTime)) {
+            enqueue(running, currentTime);
+            running = dispatch(currentTime);
+        }
+
+        Process& selectedProcess = processes[arrivalOrder[running]];
+        if (!selectedProcess.started) {
+            selectedProcess.responseTime = currentTime - selectedProcess.arrivalTime;
+            selectedProcess.started = true;
+        }
+
+        // Run until completion, the next arrival or the aging overtake
+        long long runUntil = currentTime + remainingBurst[arrivalOrder[running]];
+        if (nextArrival < n) {
+            runUntil = std::min<long long>(runUntil, processes[arrivalOrder[nextArrival]].arrivalTime);
+        }
+        if (agingRate > 0 && !readyQueue.empty()) {
+            double overtake = (readyQueue.top().key - effectivePriority[arrivalOrder[running]]) / agingRate;
+            if (overtake < runUntil) {
+                long long t = std::max(static_cast<long long>(floor(overtake)), currentTime + 1LL);
+                while (t < runUntil && !beats(readyQueue.top(), running, t)) {
+                    t++;
+                }
+                runUntil = t;
+            }
+        }
+
+        if (selectedProcess.id != lastProcessId) {
+            if (lastProcessId != -1) {
+                contextSwitches++;
+            }
+            lastProcessId = selectedProcess.id;
+            countDispatch(selectedProcess);
+            if (options.recordGantt) {
+                ganttChart.push_back({selectedProcess.id, currentTime, static_cast<int>(runUntil)});
+            }
+        } else if (options.recordGantt) {
+            ganttChart.back().endTime = static_cast<int>(runUntil);
+        }
+
+        remainingBurst[arrivalOrder[running]] -= static_cast<int>(runUntil - currentTime);
+        currentTime = static_cast<int>(runUntil);
+        if (remainingBurst[arrivalOrder[running]] == 0) {
+            selectedProcess.completionTime = currentTime;
+            selectedProcess.turnaroundTime = selectedProcess.completionTime - selectedProcess.arrivalTime;
+            selectedProcess.waitingTime = selectedProcess.turnaroundTime - selectedProcess.burstTime;
+            running = -1;
+            completed++;
+        }
+    }
+
+    AlgorithmResult result = calculateMetrics("Priority (Preemptive)", processes, std::move(ganttChart), options);
+    result.contextSwitches = contextSwitches;
+    return result;
+}
+
+// Cost of switching a CPU to another process, charged as overhead time
+// before the incoming job runs: a fixed save/restore cost, an extra cost when
+// the job last ran on another CPU, and a cache warm-up penalty when a job
+// resumes after other work has run in between.
+struct SwitchCost {
+    int fixed = 0;
+    int migration = 0;
+    int cacheWarmup = 0;
+
+    bool enabled() const {
+        return fixed > 0 || migration > 0 || cacheWarmup > 0;
+    }
+};
+
+// Tunable parameters shared by the engines, parsed from the request body
+struct AlgorithmParams {
+    int timeQuantum = 2;
+
+    // Multi-CPU simulation: per-CPU run queues (optionally with work
+    // stealing by idle CPUs) or one global queue shared by all CPUs
+    int cpus = 1;
+    bool globalQueue = false;
+    bool workStealing = true;
+
+    MlfqConfig mlfq;
+    CfsConfig cfs;
+    uint64_t lotterySeed = 1;
+    // Priority engines: effective priority gained per time unit waited
+    double agingRate = 0;
+    // Modelled by the event-driven core behind FCFS, SJF, SRTN, RR and the
+    // priority policies
+    SwitchCost switchCost;
+};
+
+enum class SmpPolicy { Fcfs, Sjf, Srtn, RoundRobin, Priority, PriorityPreemptive };
+
+// N-CPU simulation of the single-CPU policies. Event-driven: time jumps
+// between arrivals and slice ends, each run queue is a binary heap ordered by
+// the policy key, and idle CPUs are tracked in a list, so a step costs
+// O(log n) plus a scan over the CPUs only when placing or stealing work.
+// With one CPU and no switch costs the schedule matches the single-CPU
+// engines. Switch costs appear as Gantt segments with processId -2.
+AlgorithmResult smpSchedule(vector<Process> processes, SmpPolicy policy, const AlgorithmParams& params,
+                            const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    int cpuCount = std::max(1, params.cpus);
+    bool preemptive = policy == SmpPolicy::Srtn || policy == SmpPolicy::PriorityPreemptive;
+
+    vector<int> arrivalOrder(n);
+    vector<int> arrivalRank(n);
+    vector<int> remaining(n);
+    vector<int> lastCpu(n, -1);
+    for (size_t i = 0; i < n; i++) {
+        Process& p = processes[i];
+        if (policy == SmpPolicy::Sjf) {
+            // Same model as sjf(): every job is available at time 0
+            p.arrivalTime = 0;
+        }
+        p.started = false;
+        arrivalOrder[i] = static_cast<int>(i);
+        remaining[i] = p.burstTime;
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+    for (size_t r = 0; r < n; r++) {
+        arrivalRank[arrivalOrder[r]] = static_cast<int>(r);
+    }
+
+    // Run queues: min-heaps on (key, tie); ties follow the single-CPU engines
+    struct QueueItem {
+        long long key;
+        long long tie;
+        int index;
+    };
+    auto worse = [](const QueueItem& a, const QueueItem& b) {
+        return a.key != b.key ? a.key > b.key : a.tie > b.tie;
+    };
+    long long enqueueSequence = 0;
+    auto makeItem = [&](int index) -> QueueItem {
+        switch (policy) {
+            case SmpPolicy::Fcfs: return {arrivalRank[index], 0, index};
+            case SmpPolicy::Sjf: return {processes[index].burstTime, index, index};
+            case SmpPolicy::Srtn: return {remaining[index], arrivalRank[index], index};
+            case SmpPolicy::RoundRobin: return {enqueueSequence++, 0, index};
+            case SmpPolicy::Priority: return {processes[index].priority, index, index};
+            case SmpPolicy::PriorityPreemptive: return {processes[index].priority, arrivalRank[index], index};
+        }
+        return {0, 0, index};
+    };
+
+    int queueCount = params.globalQueue ? 1 : cpuCount;
+    vector<vector<QueueItem>> queues(queueCount);
+    size_t queued = 0;
+    auto enqueue = [&](int queue, int index) {
+        queues[queue].push_back(makeItem(index));
+        push_heap(queues[queue].begin(), queues[queue].end(), worse);
+        queued++;
+    };
+    auto dequeue = [&](int queue) {
+        pop_heap(queues[queue].begin(), queues[queue].end(), worse);
+        int index = queues[queue].back().index;
+        queues[queue].pop_back();
+        queued--;
+        return index;
+    };
+
+    struct Cpu {
+        int running = -1;
+        int dispatchTime = 0; // runStart minus the switch overhead
+        int runStart = 0;
+        int overheadSegment = -1;
+        int version = 0;
+        int lastProcess = -1;
+        int lastSegment = -1;
+        int lastStop = -1;
+        bool counted = false; // this run counted as a dispatch
+    };
+    vector<Cpu> cpus(cpuCount);
+    vector<int> idleCpus;
+    for (int c = cpuCount - 1; c >= 0; c--) {
+        idleCpus.push_back(c);
+    }
+
+    // Slice-end events; preempted slices are invalidated by bumping the version
+    struct SliceEnd {
+        int time;
+        int cpu;
+        int version;
+        bool operator>(const SliceEnd& other) const {
+            return time != other.time ? time > other.time : cpu > other.cpu;
+        }
+    };
+    priority_queue<SliceEnd, vector<SliceEnd>, greater<SliceEnd>> sliceEnds;
+
+    vector<GanttEntry> ganttChart;
+    TimelineRecorder timeline(options);
+    int contextSwitches = 0;
+    int migrations = 0;
+    int overheadTime = 0;
+    const SwitchCost& cost = params.switchCost;
+    const int overheadId = -2;
+
+    // Work done so far by the running job (none while still in overhead)
+    auto executed = [&](int c, int time) {
+        return std::max(0, time - cpus[c].runStart);
+    };
+
+    auto stopRunning = [&](int c, int time) {
+        Cpu& cpu = cpus[c];
+        remaining[cpu.running] -= executed(c, time);
+        timeline.addBusy(cpu.runStart, time);
+        overheadTime += std::min(time, cpu.runStart) - cpu.dispatchTime;
+        if (cpu.overheadSegment >= 0) {
+            GanttEntry& overhead = ganttChart[cpu.overheadSegment];
+            overhead.endTime = std::min(overhead.endTime, time);
+            cpu.overheadSegment = -1;
+        }
+        if (cpu.lastSegment >= 0) {
+            // Preempted during the overhead: left empty, dropped at the end
+            ganttChart[cpu.lastSegment].endTime = std::max(time, ganttChart[cpu.lastSegment].startTime);
+        }
+        int index = cpu.running;
+        cpu.running = -1;
+        cpu.lastStop = time;
+        if (cpu.counted && time <= cpu.runStart) {
+            // Stopped before running at all: not a dispatch after all
+            Process& p = processes[index];
+            p.dispatches--;
+            p.preemptions -= p.dispatches > 0 ? 1 : 0;
+            cpu.lastStop = -1;
+        }
+        cpu.version++;
+        idleCpus.push_back(c);
+        return index;
+    };
+
+    auto dispatch = [&](int c, int time, bool allowSteal) {
+        int queue = params.globalQueue ? 0 : c;
+        if (queues[queue].empty()) {
+            if (params.globalQueue || !allowSteal) {
+                return false;
+            }
+            // Steal the best job of the longest queue
+            int victim = -1;
+            for (int q = 0; q < queueCount; q++) {
+                if (!queues[q].empty() && (victim < 0 || queues[q].size() > queues[victim].size())) {
+                    victim = q;
+                }
+            }
+            if (victim < 0) {
+                return false;
+            }
+            queue = victim;
+        }
+
+        int index = dequeue(queue);
+        Process& p = processes[index];
+        Cpu& cpu = cpus[c];
+        // Picked straight back up where it stopped: the run just continues
+        cpu.counted = cpu.lastProcess != p.id || cpu.lastStop != time;
+        if (cpu.counted) {
+            countDispatch(p);
+        }
+        bool ranBefore = lastCpu[index] >= 0;
+        int overhead = 0;
+        if (ranBefore && lastCpu[index] != c) {
+            migrations++;
+            overhead += cost.migration;
+        }
+        lastCpu[index] = c;
+
+        if (cpu.lastProcess != p.id) {
+            if (cpu.lastProcess != -1) {
+                contextSwitches++;
+                overhead += cost.fixed;
+            }
+            if (ranBefore) {
+                overhead += cost.cacheWarmup;
+            }
+            cpu.lastProcess = p.id;
+        }
+
+        int start = time + overhead;
+        if (!p.started) {
+            p.responseTime = start - p.arrivalTime;
+            p.started = true;
+        }
+        int slice = policy == SmpPolicy::RoundRobin ? std::min(params.timeQuantum, remaining[index]) : remaining[index];
+        cpu.running = index;
+        cpu.dispatchTime = time;
+        cpu.runStart = start;
+        sliceEnds.push({start + slice, c, cpu.version});
+
+        if (options.recordGantt) {
+            if (overhead > 0) {
+                cpu.overheadSegment = static_cast<int>(ganttChart.size());
+                ganttChart.push_back({overheadId, time, start, c});
+            }
+            if (overhead == 0 && cpu.lastSegment >= 0 && ganttChart[cpu.lastSegment].processId == p.id &&
+                ganttChart[cpu.lastSegment].endTime == time) {
+                ganttChart[cpu.lastSegment].endTime = start + slice;
+            } else {
+                cpu.lastSegment = static_cast<int>(ganttChart.size());
+                ganttChart.push_back({p.id, start, start + slice, c});
+            }
+        }
+        return true;
+    };
+
+    // Key of a running job as if it were queued now (SRTN: remaining at `time`)
+    auto runningItem = [&](int c, int time) -> QueueItem {
+        int index = cpus[c].running;
+        if (policy == SmpPolicy::Srtn) {
+            return {remaining[index] - executed(c, time), arrivalRank[index], index};
+        }
+        return {processes[index].priority, arrivalRank[index], index};
+    };
+
+    auto admit = [&](int index, int time) {
+        int target = 0;
+        if (!params.globalQueue) {
+            // Place on the least loaded CPU (queued plus running)
+            size_t bestLoad = SIZE_MAX;
+            for (int c = 0; c < cpuCount; c++) {
+                size_t load = queues[c].size() + (cpus[c].running >= 0 ? 1 : 0);
+                if (load < bestLoad) {
+                    bestLoad = load;
+                    target = c;
+                }
+            }
+        }
+
+        if (preemptive) {
+            // Preempt the target CPU, or with a global queue the CPU running the worst job
+            QueueItem arriving = makeItem(index);
+            int victim = -1;
+            QueueItem victimItem{};
+            for (int c = 0; c < cpuCount; c++) {
+                if ((params.globalQueue || c == target) && cpus[c].running >= 0) {
+                    QueueItem item = runningItem(c, time);
+                    if (victim < 0 || worse(item, victimItem)) {
+                        victim = c;
+                        victimItem = item;
+                    }
+                }
+            }
+            if (victim >= 0 && worse(victimItem, arriving) &&
+                (!params.globalQueue || none_of(cpus.begin(), cpus.end(), [](const Cpu& cpu) { return cpu.running < 0; }))) {
+                int preempted = stopRunning(victim, time);
+                enqueue(params.globalQueue ? 0 : victim, preempted);
+            }
+        }
+        enqueue(params.globalQueue ? 0 : target, index);
+    };
+
+    size_t nextArrival = 0;
+    size_t completed = 0;
+    vector<pair<int, int>> expired;
+    int lastEventTime = 0;
+
+    while (completed < n) {
+        while (!sliceEnds.empty() && sliceEnds.top().version != cpus[sliceEnds.top().cpu].version) {
+            sliceEnds.pop();
+        }
+        int time = INT_MAX;
+        if (nextArrival < n) {
+            time = processes[arrivalOrder[nextArrival]].arrivalTime;
+        }
+        if (!sliceEnds.empty()) {
+            time = std::min(time, sliceEnds.top().time);
+        }
+        timeline.addReady(lastEventTime, time, static_cast<long long>(queued));
+        lastEventTime = time;
+
+        // Slices ending now: completed jobs leave, expired quanta requeue below
+        while (!sliceEnds.empty() && sliceEnds.top().time == time) {
+            SliceEnd event = sliceEnds.top();
+            sliceEnds.pop();
+            if (event.version != cpus[event.cpu].version) {
+                continue;
+            }
+            int index = stopRunning(event.cpu, time);
+            if (remaining[index] == 0) {
+                Process& p = processes[index];
+                p.completionTime = time;
+                p.turnaroundTime = p.completionTime - p.arrivalTime;
+                p.waitingTime = p.turnaroundTime - p.burstTime;
+                completed++;
+            } else {
+                expired.push_back({event.cpu, index});
+            }
+        }
+
+        // Arrivals at the same instant queue ahead of expired jobs, as in roundRobin()
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            admit(arrivalOrder[nextArrival++], time);
+        }
+        for (const auto& [cpu, index] : expired) {
+            enqueue(params.globalQueue ? 0 : cpu, index);
+        }
+        expired.clear();
+
+        // Hand queued work to idle CPUs, lowest CPU id first. Every CPU
+        // serves its own queue before any idle CPU steals from another.
+        if (queued > 0) {
+            sort(idleCpus.begin(), idleCpus.end(), greater<int>());
+            for (bool steal : {false, true}) {
+                if (steal && (params.globalQueue || !params.workStealing)) {
+                    break;
+                }
+                for (size_t k = idleCpus.size(); k-- > 0 && queued > 0;) {
+                    if (dispatch(idleCpus[k], time, steal)) {
+                        idleCpus.erase(idleCpus.begin() + k);
+                    }
+                }
+            }
+        }
+    }
+
+    static const char* policyNames[] = {"FCFS", "SJF", "SRTN", "Round Robin", "Priority (Non-Preemptive)",
+                                        "Priority (Preemptive)"};
+    string name = policyNames[static_cast<int>(policy)];
+    if (policy == SmpPolicy::RoundRobin) {
+        name += " (TQ=" + to_string(params.timeQuantum) + ")";
+    }
+    if (cpuCount > 1) {
+        name += " [" + to_string(cpuCount) + " CPUs, " + (params.globalQueue ? "global queue" : "per-CPU queues") + "]";
+    }
+    if (cost.enabled()) {
+        ganttChart.erase(remove_if(ganttChart.begin(), ganttChart.end(),
+                                   [](const GanttEntry& entry) { return entry.endTime <= entry.startTime; }),
+                         ganttChart.end());
+    }
+
+    SimOptions metricsOptions = options;
+    metricsOptions.timelineBucket = 0;
+    AlgorithmResult result = calculateMetrics(name, processes, std::move(ganttChart), metricsOptions, cpuCount);
+    result.contextSwitches = contextSwitches;
+    result.migrations = migrations;
+    result.overheadTime = overheadTime;
+    result.idleTime -= overheadTime;
+    result.timeline = timeline.finish(result.makespan, cpuCount);
+    return result;
+}
+
+// One step of a process's behaviour: a CPU burst, an I/O burst on the given
+// device, a sleep, or the end of the process (length 0). A source that has
+// no burst yet (the process waits on an event) returns `blocked` and later
+// reports the process through takeWoken().
+struct Burst {
+    int length;
+    int device;
+
+    static constexpr int cpu = -1;
+    static constexpr int sleep = -2;
+    static constexpr int blocked = -3;
+};
+
+// CPU/I-O burst sequences stored flat: process i owns
+// lengths[start[i] .. start[i + 1]), alternating CPU and I/O bursts and
+// starting with CPU; devices[k] is the device of I/O burst k.
+struct BurstTrace {
+    vector<int> start = {0};
+    vector<int> lengths;
+    vector<int> devices;
+};
+
+// Burst source that replays a BurstTrace
+class TraceBursts {
+public:
+    explicit TraceBursts(const BurstTrace& trace)
+        : trace(trace), cursor(trace.start.begin(), trace.start.end() - 1) {}
+
+    Burst next(int index) {
+        if (cursor[index] == trace.start[index + 1]) {
+            return {0, Burst::cpu};
+        }
+        int k = cursor[index]++;
+        bool io = (k - trace.start[index]) % 2 == 1;
+        return {trace.lengths[k], io ? trace.devices[k] : Burst::cpu};
+    }
+
+    void takeWoken(vector<int>&) {}
+
+private:
+    const BurstTrace& trace;
+    vector<int> cursor;
+};
+
+enum class IoPolicy { Fcfs, RoundRobin, Srtn, PriorityPreemptive };
+
+// Single-CPU simulation of processes that alternate CPU and I/O bursts. Each
+// I/O device serves its own FCFS queue concurrently with the CPU. Event-driven
+// over arrivals, CPU slice ends, device completions and sleep timers
+// (O(log n) each); the next burst of a process is pulled from `source` only
+// when the previous one ends, so sources may generate bursts on the fly.
+// Waiting time is time spent in the CPU ready queue; burstTime is reported as
+// total CPU time. Processes still blocked when no event is left are counted
+// in io.blocked and finish at that time.
+template <typename Source>
+AlgorithmResult ioSchedule(vector<Process> processes, Source& source, IoPolicy policy, int timeQuantum,
+                           int deviceCount, const SimOptions& options = SimOptions()) {
+    size_t n = processes.size();
+    vector<int> arrivalOrder(n);
+    vector<int> arrivalRank(n);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].started = false;
+        processes[i].burstTime = 0;
+        processes[i].completionTime = -1;
+        arrivalOrder[i] = static_cast<int>(i);
+    }
+    stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+    for (size_t r = 0; r < n; r++) {
+        arrivalRank[arrivalOrder[r]] = static_cast<int>(r);
+    }
+
+    vector<int> remaining(n, 0); // of the current CPU burst
+    vector<char> midBurst(n, 0); // the current CPU burst has been preempted
+    vector<int> readySince(n, 0);
+    vector<int> readyWait(n, 0);
+
+    // CPU ready queue: min-heap on (key, tie) like the SMP core
+    struct QueueItem {
+        long long key;
+        long long tie;
+        int index;
+    };
+    auto worse = [](const QueueItem& a, const QueueItem& b) {
+        return a.key != b.key ? a.key > b.key : a.tie > b.tie;
+    };
+    long long enqueueSequence = 0;
+    auto makeItem = [&](int index, int executed) -> QueueItem {
+        switch (policy) {
+            case IoPolicy::Srtn: return {remaining[index] - executed, arrivalRank[index], index};
+            case IoPolicy::PriorityPreemptive: return {processes[index].priority, arrivalRank[index], index};
+            default: return {enqueueSequence++, 0, index};
+        }
+    };
+    vector<QueueItem> ready;
+    auto makeReady = [&](int index, int time) {
+        readySince[index] = time;
+        ready.push_back(makeItem(index, 0));
+        push_heap(ready.begin(), ready.end(), worse);
+    };
+
+    // Devices: FCFS queues, completions ordered in a min-heap
+    struct IoRequest {
+        int index;
+        int length;
+        int since;
+    };
+    struct Device {
+        deque<IoRequest> queue;
+        int serving = -1;
+        long long busyTime = 0;
+    };
+    vector<Device> devices(deviceCount);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> deviceEvents;
+    // Sleeping processes by wake-up time
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> timers;
+    int busyDevices = 0;
+    long long totalIoWait = 0;
+    long long ioBursts = 0;
+
+    AlgorithmResult result;
+    vector<GanttEntry> ganttChart;
+    vector<GanttEntry>& ioChart = result.io.ioChart;
+    TimelineRecorder timeline(options);
+
+    auto serve = [&](int d, const IoRequest& request, int time) {
+        Device& device = devices[d];
+        device.serving = request.index;
+        device.busyTime += request.length;
+        busyDevices++;
+        totalIoWait += time - request.since;
+        deviceEvents.push({time + request.length, d});
+        if (options.recordGantt) {
+            ioChart.push_back({processes[request.index].id, time, time + request.length, d});
+        }
+    };
+
+    size_t completed = 0;
+    auto finish = [&](int index, int time) {
+        Process& p = processes[index];
+        p.completionTime = time;
+        p.turnaroundTime = time - p.arrivalTime;
+        p.waitingTime = readyWait[index];
+        if (!p.started) {
+            p.responseTime = p.turnaroundTime;
+        }
+        completed++;
+    };
+    // Pulls the next burst of a process once the previous one has ended,
+    // along with any processes the source woke up in the meantime
+    vector<int> pending;
+    auto advanceProcess = [&](int first, int time) {
+        pending.assign(1, first);
+        for (size_t k = 0; k < pending.size(); k++) {
+            int index = pending[k];
+            Burst burst = source.next(index);
+            source.takeWoken(pending);
+            if (burst.device == Burst::blocked) {
+                continue;
+            }
+            if (burst.length <= 0) {
+                finish(index, time);
+            } else if (burst.device == Burst::cpu) {
+                remaining[index] = burst.length;
+                midBurst[index] = 0;
+                makeReady(index, time);
+            } else if (burst.device == Burst::sleep) {
+                timers.push({time + burst.length, index});
+            } else {
+                int d = std::min(std::max(burst.device, 0), deviceCount - 1);
+                ioBursts++;
+                if (devices[d].serving < 0) {
+                    serve(d, {index, burst.length, time}, time);
+                } else {
+                    devices[d].queue.push_back({index, burst.length, time});
+                }
+            }
+        }
+    };
+
+    int currentTime = 0;
+    int running = -1;
+    int runStart = 0;
+    int sliceEnd = 0;
+    int lastStop = -1;
+    int lastProcessId = -1;
+    int contextSwitches = 0;
+    long long overlapTime = 0;
+    size_t nextArrival = 0;
+    bool preemptive = policy == IoPolicy::Srtn || policy == IoPolicy::PriorityPreemptive;
+
+    auto stopRunning = [&](int time) {
+        int index = running;
+        int ran = time - runStart;
+        remaining[index] -= ran;
+        processes[index].burstTime += ran;
+        midBurst[index] = remaining[index] > 0;
+        running = -1;
+        lastStop = time;
+        if (options.recordGantt) {
+            ganttChart.back().endTime = time;
+        }
+        return index;
+    };
+
+    while (completed < n) {
+        int time = INT_MAX;
+        if (nextArrival < n) {
+            time = processes[arrivalOrder[nextArrival]].arrivalTime;
+        }
+        if (running >= 0) {
+            time = std::min(time, sliceEnd);
+        }
+        if (!deviceEvents.empty()) {
+            time = std::min(time, deviceEvents.top().first);
+        }
+        if (!timers.empty()) {
+            time = std::min(time, timers.top().first);
+        }
+        if (time == INT_MAX) {
+            // Everyone left is waiting on an event that can no longer happen
+            for (size_t i = 0; i < n; i++) {
+                if (processes[i].completionTime < 0) {
+                    finish(static_cast<int>(i), currentTime);
+                    result.io.blocked++;
+                }
+            }
+            break;
+        }
+        if (running >= 0 && busyDevices > 0) {
+            overlapTime += time - currentTime;
+        }
+        if (running >= 0) {
+            timeline.addBusy(currentTime, time);
+        }
+        timeline.addReady(currentTime, time, static_cast<long long>(ready.size()));
+        currentTime = time;
+
+        int expired = -1;
+        if (running >= 0 && sliceEnd == time) {
+            int index = stopRunning(time);
+            if (remaining[index] == 0) {
+                advanceProcess(index, time);
+            } else {
+                expired = index;
+            }
+        }
+
+        // A finished request hands the device to the next queued one first
+        while (!deviceEvents.empty() && deviceEvents.top().first == time) {
+            int d = deviceEvents.top().second;
+            deviceEvents.pop();
+            int index = devices[d].serving;
+            devices[d].serving = -1;
+            busyDevices--;
+            if (!devices[d].queue.empty()) {
+                serve(d, devices[d].queue.front(), time);
+                devices[d].queue.pop_front();
+            }
+            advanceProcess(index, time);
+        }
+        while (!timers.empty() && timers.top().first == time) {
+            int index = timers.top().second;
+            timers.pop();
+            advanceProcess(index, time);
+        }
+
+        // Arrivals at the same instant queue ahead of an expired quantum, as in roundRobin()
+        while (nextArrival < n && processes[arrivalOrder[nextArrival]].arrivalTime <= time) {
+            advanceProcess(arrivalOrder[nextArrival++], time);
+        }
+        if (expired >= 0) {
+            makeReady(expired, time);
+        }
+
+        if (running >= 0 && preemptive && !ready.empty() && worse(makeItem(running, time - runStart), ready.front())) {
+            makeReady(stopRunning(time), time);
+        }
+
+        if (running < 0 && !ready.empty()) {
+            pop_heap(ready.begin(), ready.end(), worse);
+            running = ready.back().index;
+            ready.pop_back();
+
+            Process& p = processes[running];
+            readyWait[running] += time - readySince[running];
+            if (!p.started) {
+                p.responseTime = time - p.arrivalTime;
+                p.started = true;
+            }
+            runStart = time;
+            sliceEnd = time + (policy == IoPolicy::RoundRobin ? std::min(timeQuantum, remaining[running])
+                                                              : remaining[running]);
+            // Picked straight back up where it stopped: the run just continues
+            if (p.id != lastProcessId || lastStop != time) {
+                p.dispatches++;
+                p.preemptions += midBurst[running];
+            }
+            if (p.id != lastProcessId) {
+                if (lastProcessId != -1) {
+                    contextSwitches++;
+                }
+                lastProcessId = p.id;
+            }
+            if (options.recordGantt) {
+                if (!ganttChart.empty() && ganttChart.back().processId == p.id && ganttChart.back().endTime == time) {
+                    ganttChart.back().endTime = sliceEnd;
+                } else {
+                    ganttChart.push_back({p.id, time, sliceEnd});
+                }
+            }
+        }
+    }
+
+    static const char* policyNames[] = {"FCFS", "Round Robin", "SRTN", "Priority (Preemptive)"};
+    string name = policyNames[static_cast<int>(policy)];
+    if (policy == IoPolicy::RoundRobin) {
+        name += " (TQ=" + to_string(timeQuantum) + ")";
+    }
+    IoStats io = std::move(result.io);
+    SimOptions metricsOptions = options;
+    metricsOptions.timelineBucket = 0;
+    result = calculateMetrics(name + " + I/O", processes, std::move(ganttChart), metricsOptions);
+    result.contextSwitches = contextSwitches;
+    result.timeline = timeline.finish(result.makespan, 1);
+
+    double makespan = result.makespan > 0 ? result.makespan : 1;
+    for (const auto& device : devices) {
+        io.deviceUtilization.push_back(100.0 * device.busyTime / makespan);
+    }
+    io.overlap = 100.0 * overlapTime / makespan;
+    io.avgIoWaitTime = ioBursts > 0 ? static_cast<double>(totalIoWait) / ioBursts : 0;
+    result.io = std::move(io);
+    return result;
+}
+
+// Coroutine frames come from per-thread free lists (one per 16-byte size
+// class) carved out of 1 MiB blocks: millions of simulated processes cost one
+// allocation per block, and frames of a finished run are reused by the next.
+// A frame must be released on the thread that allocated it.
+class FrameArena {
+public:
+    void* allocate(size_t size) {
+        size_t sizeClass = (size + 15) / 16;
+        if (sizeClass >= freeLists.size()) {
+            freeLists.resize(sizeClass + 1, nullptr);
+        }
+        if (void* frame = freeLists[sizeClass]) {
+            freeLists[sizeClass] = *static_cast<void**>(frame);
+            return frame;
+        }
+        size_t bytes = sizeClass * 16;
+        if (blocks.empty() || used + bytes > blockSize) {
+            blocks.push_back(make_unique<unsigned char[]>(std::max(blockSize, bytes)));
+            used = 0;
+        }
+        void* frame = blocks.back().get() + used;
+        used += bytes;
+        return frame;
+    }
+
+    void release(void* frame, size_t size) {
+        size_t sizeClass = (size + 15) / 16;
+        *static_cast<void**>(frame) = freeLists[sizeClass];
+        freeLists[sizeClass] = frame;
+    }
+
+private:
+    static constexpr size_t blockSize = 1 << 20;
+    vector<unique_ptr<unsigned char[]>> blocks;
+    size_t used = 0;
+    vector<void*> freeLists;
+};
+
+FrameArena& frameArena() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+// Simulated process behaviour written as a coroutine. It suspends on every
+// request (a burst, an event wait or a signal), and the simulator resumes it
+// once the request has been carried out.
+class ProcessBehavior {
+public:
+    struct promise_type {
+        Burst request{0, Burst::cpu};
+
+        ProcessBehavior get_return_object() {
+            return ProcessBehavior(coroutine_handle<promise_type>::from_promise(*this));
+        }
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return frameArena().allocate(size); }
+        static void operator delete(void* frame, size_t size) { frameArena().release(frame, size); }
+    };
+
+    ProcessBehavior() = default;
+    ProcessBehavior(ProcessBehavior&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    ProcessBehavior& operator=(ProcessBehavior&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~ProcessBehavior() { reset(); }
+
+    // Runs up to the next request; false once the behaviour has returned
+    bool resume(Burst& request) {
+        handle.resume();
+        if (handle.done()) {
+            return false;
+        }
+        request = handle.promise().request;
+        return true;
+    }
+
+private:
+    explicit ProcessBehavior(coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    void reset() {
+        if (handle) {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+
+    coroutine_handle<promise_type> handle;
+};
+
+// Requests that never reach the engine: handled by CoroutineBursts itself
+constexpr int waitRequest = -4;
+constexpr int signalRequest = -5;
+
+// co_await-ed by behaviours to hand a request to the simulator
+struct BehaviorRequest {
+    Burst request;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(coroutine_handle<ProcessBehavior::promise_type> handle) noexcept {
+        handle.promise().request = request;
+    }
+    void await_resume() const noexcept {}
+};
+
+BehaviorRequest compute(int length) { return {{length, Burst::cpu}}; }
+BehaviorRequest ioOn(int device, int length) { return {{length, device}}; }
+BehaviorRequest sleepFor(int length) { return {{length, Burst::sleep}}; }
+// Events count signals: a wait consumes one, or blocks until one arrives
+BehaviorRequest waitEvent(int event) { return {{event, waitRequest}}; }
+BehaviorRequest signalEvent(int event) { return {{event, signalRequest}}; }
+
+// Burst source for ioSchedule() driven by process coroutines. Event waiters
+// form intrusive FIFO lists, so an event costs three ints plus one per process.
+class CoroutineBursts {
+public:
+    CoroutineBursts(vector<ProcessBehavior> behaviors, int eventCount)
+        : behaviors(std::move(behaviors)), signals(eventCount, 0), waitHead(eventCount, -1),
+          waitTail(eventCount, -1), nextWaiter(this->behaviors.size(), -1) {}
+
+    Burst next(int index) {
+        Burst request;
+        while (behaviors[index].resume(request)) {
+            if (request.device == signalRequest || request.device == waitRequest) {
+                int event = request.length;
+                if (event < 0 || event >= static_cast<int>(signals.size())) {
+                    continue;
+                }
+                if (request.device == signalRequest) {
+                    signal(event);
+                } else if (signals[event] > 0) {
+                    signals[event]--;
+                } else {
+                    addWaiter(event, index);
+                    return {0, Burst::blocked};
+                }
+            } else if (request.length > 0) {
+                return request;
+            }
+        }
+        return {0, Burst::cpu};
+    }
+
+    void takeWoken(vector<int>& out) {
+        out.insert(out.end(), woken.begin(), woken.end());
+        woken.clear();
+    }
+
+private:
+    void signal(int event) {
+        int waiter = waitHead[event];
+        if (waiter < 0) {
+            signals[event]++;
+            return;
+        }
+        waitHead[event] = nextWaiter[waiter];
+        if (waitHead[event] < 0) {
+            waitTail[event] = -1;
+        }
+        woken.push_back(waiter);
+    }
+
+    void addWaiter(int event, int index) {
+        nextWaiter[index] = -1;
+        if (waitTail[event] < 0) {
+            waitHead[event] = index;
+        } else {
+            nextWaiter[waitTail[event]] = index;
+        }
+        waitTail[event] = index;
+    }
+
+    vector<ProcessBehavior> behaviors;
+    vector<int> signals;
+    vector<int> waitHead;
+    vector<int> waitTail;
+    vector<int> nextWaiter;
+    vector<int> woken;
+};
+
+// Per-process burst length jitter (splitmix64): uniform in [mean / 2, 3 * mean / 2]
+struct BurstJitter {
+    uint64_t state;
+
+    int draw(int mean) {
+        if (mean <= 1) {
+            return std::max(mean, 1);
+        }
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return mean / 2 + static_cast<int>(z % static_cast<uint64_t>(mean + 1));
+    }
+};
+
+// Built-in behaviour models
+ProcessBehavior cpuBoundModel(int work, int chunk, BurstJitter jitter) {
+    for (int done = 0; done < work;) {
+        int burst = std::min(jitter.draw(chunk), work - done);
+        done += burst;
+        co_await compute(burst);
+    }
+}
+
+ProcessBehavior ioBoundModel(int iterations, int cpu, int io, int device, BurstJitter jitter) {
+    for (int i = 0; i < iterations; i++) {
+        co_await compute(jitter.draw(cpu));
+        co_await ioOn(device, jitter.draw(io));
+    }
+    co_await compute(jitter.draw(cpu));
+}
+
+ProcessBehavior interactiveModel(int iterations, int think, int cpu, BurstJitter jitter) {
+    for (int i = 0; i < iterations; i++) {
+        co_await sleepFor(jitter.draw(think));
+        co_await compute(jitter.draw(cpu));
+    }
+}
+
+ProcessBehavior producerModel(int items, int cpu, int event, BurstJitter jitter) {
+    for (int i = 0; i < items; i++) {
+        co_await compute(jitter.draw(cpu));
+        co_await signalEvent(event);
+    }
+}
+
+ProcessBehavior consumerModel(int items, int cpu, int event, BurstJitter jitter) {
+    for (int i = 0; i < items; i++) {
+        co_await waitEvent(event);
+        co_await compute(jitter.draw(cpu));
+    }
+}
+
+// A group of processes running the same model; "pipeline" groups spawn
+// `count` producer/consumer pairs linked by one event each
+struct ModelGroup {
+    string model;
+    int count = 1;
+    int firstArrival = 0;
+    int arrivalInterval = 0;
+    int priority = 0;
+    int iterations = 10;
+    int cpu = 4;
+    int io = 10;
+    int device = 0;
+    int think = 20;
+    int work = 100;
+};
+
+struct ModelWorkload {
+    vector<ModelGroup> groups;
+    vector<Process> processes;
+    int eventCount = 0;
+    uint64_t seed = 1;
+
+    // Expands the groups into processes (ids from 1, in group order)
+    void expand() {
+        processes.clear();
+        eventCount = 0;
+        for (const auto& group : groups) {
+            bool pipeline = group.model == "pipeline";
+            for (int k = 0; k < group.count; k++) {
+                for (int member = 0; member < (pipeline ? 2 : 1); member++) {
+                    Process p;
+                    p.id = static_cast<int>(processes.size()) + 1;
+                    p.arrivalTime = group.firstArrival + k * group.arrivalInterval;
+                    p.burstTime = 0;
+                    p.priority = group.priority;
+                    processes.push_back(p);
+                }
+                eventCount += pipeline ? 1 : 0;
+            }
+        }
+    }
+
+    // Fresh behaviours for one run, in process order
+    vector<ProcessBehavior> spawn() const {
+        vector<ProcessBehavior> behaviors;
+        behaviors.reserve(processes.size());
+        int event = 0;
+        for (const auto& group : groups) {
+            for (int k = 0; k < group.count; k++) {
+                auto jitter = [&]() {
+                    return BurstJitter{seed ^ (0x9E3779B97F4A7C15ULL * (behaviors.size() + 1))};
+                };
+                if (group.model == "cpuBound") {
+                    behaviors.push_back(cpuBoundModel(group.work, group.cpu, jitter()));
+                } else if (group.model == "ioBound") {
+                    behaviors.push_back(ioBoundModel(group.iterations, group.cpu, group.io, group.device, jitter()));
+                } else if (group.model == "interactive") {
+                    behaviors.push_back(interactiveModel(group.iterations, group.think, group.cpu, jitter()));
+                } else {
+                    behaviors.push_back(producerModel(group.iterations, group.cpu, event, jitter()));
+                    behaviors.push_back(consumerModel(group.iterations, group.cpu, event, jitter()));
+                    event++;
+                }
+            }
+        }
+        return behaviors;
+    }
+};
+
+// Multiple CPUs and switch costs need the event-driven SMP core
+bool usesSmpCore(const AlgorithmParams& params) {
+    return params.cpus > 1 || params.switchCost.enabled();
+}
+
+// Round Robin at a given quantum, as evaluated by the sweep and the tuner
+AlgorithmResult roundRobinAt(const vector<Process>& processes, int timeQuantum, const SwitchCost& switchCost,
+                             const SimOptions& options) {
+    if (!switchCost.enabled()) {
+        return roundRobin(processes, timeQuantum, options);
+    }
+    AlgorithmParams params;
+    params.timeQuantum = timeQuantum;
+    params.switchCost = switchCost;
+    return smpSchedule(processes, SmpPolicy::RoundRobin, params, options);
+}
+
+// Algorithms selectable by key in the "algorithms" object of a request
+struct AlgorithmEntry {
+    const char* key;
+    AlgorithmResult (*run)(const vector<Process>&, const AlgorithmParams&, const SimOptions&);
+    // Work-conserving and only driven by arrivals: busy periods can run
+    // independently (single CPU only)
+    bool splitsAtIdle;
+    // processMetrics come back in arrival order instead of input order
+    bool arrivalOrdered;
+    // Runs on the SMP core when usesSmpCore(), so cpus and switchCost apply
+    bool smpCore;
+};
+
+const vector<AlgorithmEntry>& algorithmRegistry() {
+    static const vector<AlgorithmEntry> registry = {
+        {"fcfs", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return usesSmpCore(a) ? smpSchedule(p, SmpPolicy::Fcfs, a, o) : fcfs(p, o);
+        }, true, true, true},
+        {"sjf", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return usesSmpCore(a) ? smpSchedule(p, SmpPolicy::Sjf, a, o) : sjf(p, o);
+        }, false, false, true},
+        {"srtn", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return usesSmpCore(a) ? smpSchedule(p, SmpPolicy::Srtn, a, o) : srtn(p, o);
+        }, true, false, true},
+        {"roundRobin", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return usesSmpCore(a) ? smpSchedule(p, SmpPolicy::RoundRobin, a, o) : roundRobin(p, a.timeQuantum, o);
+        }, true, false, true},
+        {"priority", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return usesSmpCore(a) ? smpSchedule(p, SmpPolicy::Priority, a, o) : priorityNonPreemptive(p, a.agingRate, o);
+        }, true, false, true},
+        {"priorityPreemptive", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return usesSmpCore(a) ? smpSchedule(p, SmpPolicy::PriorityPreemptive, a, o) : priorityPreemptive(p, a.agingRate, o);
+        }, true, false, true},
+        {"mlfq", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return mlfq(p, a.mlfq, o);
+        }, true, false, false},
+        {"cfs", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return cfs(p, a.cfs, o);
+        }, true, false, false},
+        {"stride", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return proportionalShare(p, a.timeQuantum, false, 0, o);
+        }, true, false, false},
+        // A lottery draws from one random stream, so busy periods are not independent
+        {"lottery", [](const vector<Process>& p, const AlgorithmParams& a, const SimOptions& o) {
+            return proportionalShare(p, a.timeQuantum, true, a.lotterySeed, o);
+        }, false, false, false},
+        {"hrrn", [](const vector<Process>& p, const AlgorithmParams&, const SimOptions& o) {
+            return hrrn(p, o);
+        }, true, false, false},
+        {"edf", [](const vector<Process>& p, const AlgorithmParams&, const SimOptions& o) {
+            return edf(p, true, o);
+        }, true, false, false},
+        {"edfNonPreemptive", [](const vector<Process>& p, const AlgorithmParams&, const SimOptions& o) {
+            return edf(p, false, o);
+        }, true, false, false},
+    };
+    return registry;
+}
+
+// Engines off the SMP core would silently run one zero-cost CPU, so their
+// numbers would not be comparable. Returns an error message, or "".
+string checkAlgorithmParams(const AlgorithmEntry& algorithm, const AlgorithmParams& params) {
+    if (!algorithm.smpCore && usesSmpCore(params)) {
+        return string(algorithm.key) + " does not support cpus > 1 or switchCost";
+    }
+    return "";
+}
+
+const int maxSweepPoints = 10000;
+const int maxModelProcesses = 10000000;
+const int maxTimelinePoints = 10000;
+const int maxLodBuckets = 10000;
+const int maxPageLimit = 10000;
+
+// Runs body(i) for every i in [0, count) on all hardware threads. Indices are
+// handed out one at a time so uneven work items still balance across cores.
+template <typename Body>
+void parallelFor(size_t count, Body body) {
+    size_t workers = std::min<size_t>(count, std::max(1u, thread::hardware_concurrency()));
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            body(i);
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t w = 1; w < workers; w++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// Counter-based generator (Philox4x32-10, Salmon et al., SC'11): each output
+// block is a pure function of the key and a 128-bit counter, so any part of
+// a stream can be drawn on its own
+struct Philox4x32 {
+    array<uint32_t, 2> key;
+
+    array<uint32_t, 4> operator()(array<uint32_t, 4> counter) const {
+        array<uint32_t, 2> k = key;
+        for (int round = 0; round < 10; round++) {
+            uint64_t product0 = static_cast<uint64_t>(0xD2511F53) * counter[0];
+            uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57) * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ k[0], static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ k[1], static_cast<uint32_t>(product0)};
+            k[0] += 0x9E3779B9;
+            k[1] += 0xBB67AE85;
+        }
+        return counter;
+    }
+};
+
+// Integer in [low, high] from 64 random bits (bias below 2^-32 for any int range)
+int uniformInt(uint32_t lowBits, uint32_t highBits, int low, int high) {
+    uint64_t bits = static_cast<uint64_t>(highBits) << 32 | lowBits;
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(high) - low) + 1;
+    return low + static_cast<int>(static_cast<unsigned __int128>(bits) * range >> 64);
+}
+
+// Process i is drawn from Philox counters (i, 0) and (i, 1) under the seed,
+// so chunks fill in parallel and a seed gives the same workload whatever
+// the thread count
+vector<Process> generateRandomProcesses(int count, uint64_t seed) {
+    vector<Process> processes(std::max(count, 0));
+    Philox4x32 philox{{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}};
+    int maxArrival = count < 10 ? 10 : static_cast<int>(std::min<long long>(2LL * count, INT_MAX));
+    int maxPriority = std::max(1, static_cast<int>(std::min<long long>(2LL * count, INT_MAX)));
+
+    const size_t chunk = 1 << 16;
+    parallelFor((processes.size() + chunk - 1) / chunk, [&](size_t c) {
+        size_t end = std::min(processes.size(), (c + 1) * chunk);
+        for (size_t i = c * chunk; i < end; i++) {
+            uint32_t low = static_cast<uint32_t>(i);
+            uint32_t high = static_cast<uint32_t>(static_cast<uint64_t>(i) >> 32);
+            array<uint32_t, 4> first = philox({low, high, 0, 0});
+            array<uint32_t, 4> second = philox({low, high, 1, 0});
+
+            Process& p = processes[i];
+            p.id = static_cast<int>(i) + 1;
+            p.burstTime = uniformInt(second[0], second[1], 1, 100);
+            p.arrivalTime = uniformInt(first[0], first[1], 0, maxArrival);
+            p.priority = uniformInt(first[2], first[3], 1, maxPriority);
+        }
+    });
+    return processes;
+}
+
+// Busy periods: with a work-conserving policy the CPU only idles when every
+// arrived job is done, so the schedule splits at those instants into periods
+// that never interact. One prefix pass over arrival-sorted work finds them.
+// Returns the input indices of each period, in input order.
+vector<vector<int>> findBusyPeriods(const vector<Process>& processes) {
+    vector<int> order(processes.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<int>(i);
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return processes[a].arrivalTime < processes[b].arrivalTime;
+    });
+
+    vector<int> periodOf(processes.size());
+    int periods = 0;
+    long long busyUntil = 0;
+    for (int index : order) {
+        const Process& p = processes[index];
+        if (periods == 0 || p.arrivalTime > busyUntil) {
+            periods++;
+            busyUntil = p.arrivalTime;
+        }
+        busyUntil += p.burstTime;
+        periodOf[index] = periods - 1;
+    }
+
+    vector<vector<int>> result(periods);
+    for (size_t i = 0; i < processes.size(); i++) {
+        result[periodOf[i]].push_back(static_cast<int>(i));
+    }
+    return result;
+}
+
+// Runs a splitsAtIdle engine on independent busy periods in parallel and
+// stitches the Gantt charts and metrics back together. Consecutive periods
+// are grouped into chunks of similar size so tiny periods don't each become
+// a task; the result matches a serial run of the engine.
+AlgorithmResult runByBusyPeriods(const vector<Process>& processes, const AlgorithmEntry& algorithm,
+                                 const AlgorithmParams& params, const SimOptions& options) {
+    vector<vector<int>> periods = findBusyPeriods(processes);
+
+    size_t targetChunks = std::max<size_t>(1, thread::hardware_concurrency()) * 4;
+    size_t chunkSize = std::max<size_t>(1, processes.size() / targetChunks);
+    vector<vector<int>> chunks;
+    for (auto& period : periods) {
+        if (chunks.empty() || chunks.back().size() >= chunkSize) {
+            chunks.emplace_back();
+        }
+        chunks.back().insert(chunks.back().end(), period.begin(), period.end());
+    }
+    if (chunks.size() <= 1) {
+        return algorithm.run(processes, params, options);
+    }
+
+    // Per-process rows are needed internally for the stitched percentiles
+    SimOptions chunkOptions = options;
+    chunkOptions.recordProcesses = true;
+    chunkOptions.timelineBucket = 0;
+
+    vector<AlgorithmResult> results(chunks.size());
+    parallelFor(chunks.size(), [&](size_t c) {
+        // Chunk indices stay in input order, so input-ordered engines see
+        // the same relative order (and tie-breaking) as in a serial run
+        sort(chunks[c].begin(), chunks[c].end());
+        vector<Process> subset;
+        subset.reserve(chunks[c].size());
+        for (int index : chunks[c]) {
+            subset.push_back(processes[index]);
+        }
+        results[c] = algorithm.run(subset, params, chunkOptions);
+    });
+
+    AlgorithmResult stitched;
+    stitched.name = results.front().name;
+    stitched.processMetrics.resize(processes.size());
+    double totalTurnaroundTime = 0;
+    double totalWaitingTime = 0;
+    double totalResponseTime = 0;
+    double totalCompletionTime = 0;
+    size_t position = 0;
+    for (size_t c = 0; c < chunks.size(); c++) {
+        AlgorithmResult& result = results[c];
+        double count = static_cast<double>(chunks[c].size());
+        // Chunk averages are integer totals divided by count: round back exactly
+        totalTurnaroundTime += llround(result.avgTurnaroundTime * count);
+        totalWaitingTime += llround(result.avgWaitingTime * count);
+        totalResponseTime += llround(result.avgResponseTime * count);
+        totalCompletionTime += llround(result.avgCompletionTime * count);
+        stitched.contextSwitches += result.contextSwitches + (c > 0 ? 1 : 0);
+        stitched.preemptions += result.preemptions;
+        stitched.makespan = std::max(stitched.makespan, result.makespan);
+
+        if (options.recordGantt) {
+            // Each chunk's idle segments start at time 0: redone below
+            copy_if(result.ganttChart.begin(), result.ganttChart.end(), back_inserter(stitched.ganttChart),
+                    [](const GanttEntry& entry) { return entry.processId != idleProcessId; });
+        }
+        for (size_t k = 0; k < result.processMetrics.size(); k++) {
+            size_t target = algorithm.arrivalOrdered ? position++ : chunks[c][k];
+            stitched.processMetrics[target] = result.processMetrics[k];
+        }
+    }
+
+    double n = static_cast<double>(processes.size());
+    stitched.avgTurnaroundTime = totalTurnaroundTime / n;
+    stitched.avgWaitingTime = totalWaitingTime / n;
+    stitched.avgResponseTime = totalResponseTime / n;
+    stitched.avgCompletionTime = totalCompletionTime / n;
+    stitched.throughput = n / stitched.makespan;
+    double totalBurstTime = 0;
+    for (const auto& p : processes) {
+        totalBurstTime += p.burstTime;
+    }
+    stitched.cpuUtilization = stitched.makespan > 0 ? 100.0 * totalBurstTime / stitched.makespan : 0;
+    stitched.idleTime = stitched.makespan - static_cast<long long>(totalBurstTime);
+    if (options.recordGantt) {
+        addIdleSegments(stitched.ganttChart, 1, stitched.makespan);
+    }
+    if (options.timelineBucket > 0) {
+        stitched.timeline = singleCpuTimeline(stitched.processMetrics, stitched.makespan, options);
+    }
+
+    CompletionRecorder recorder(options.starvationThreshold);
+    vector<int> lateness;
+    for (const auto& pm : stitched.processMetrics) {
+        recorder.record(pm.waitingTime, pm.responseTime, pm.turnaroundTime, pm.burstTime, pm.priority);
+        if (pm.deadline != noDeadline) {
+            lateness.push_back(pm.completionTime - pm.deadline);
+        }
+    }
+    recorder.finish(stitched);
+    stitched.deadlines = deadlineStats(lateness);
+    stitched.shares = shareStats(stitched.processMetrics);
+    if (!options.recordProcesses) {
+        stitched.processMetrics.clear();
+        stitched.processMetrics.shrink_to_fit();
+    }
+    return stitched;
+}
+
+// Work-stealing runner for a fixed set of tasks: each worker starts with a
+// contiguous share of task indices, pops from the front of its own deque and,
+// once empty, steals from the back of the other workers' deques.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t workers = thread::hardware_concurrency())
+        : queues(std::max<size_t>(1, workers)) {}
+
+    template <typename Task>
+    void run(size_t count, Task task) {
+        size_t workers = std::min(queues.size(), std::max<size_t>(1, count));
+        for (size_t w = 0; w < workers; w++) {
+            for (size_t i = count * w / workers; i < count * (w + 1) / workers; i++) {
+                queues[w].tasks.push_back(i);
+            }
+        }
+
+        auto worker = [&](size_t self) {
+            size_t index;
+            while (popOwn(self, index) || steal(self, workers, index)) {
+                task(index);
+            }
+        };
+
+        vector<thread> threads;
+        for (size_t w = 1; w < workers; w++) {
+            threads.emplace_back(worker, w);
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+private:
+    struct WorkerQueue {
+        mutex mtx;
+        deque<size_t> tasks;
+    };
+
+    bool popOwn(size_t self, size_t& index) {
+        lock_guard<mutex> lock(queues[self].mtx);
+        if (queues[self].tasks.empty()) {
+            return false;
+        }
+        index = queues[self].tasks.front();
+        queues[self].tasks.pop_front();
+        return true;
+    }
+
+    // Tasks are never added after run() starts, so one empty pass means done
+    bool steal(size_t self, size_t workers, size_t& index) {
+        for (size_t k = 1; k < workers; k++) {
+            WorkerQueue& victim = queues[(self + k) % workers];
+            lock_guard<mutex> lock(victim.mtx);
+            if (!victim.tasks.empty()) {
+                index = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    vector<WorkerQueue> queues;
+};
+
+// Time-quantum tuning: the objective is a weighted sum of RR metrics
+struct TuningObjective {
+    double avgWaitingTime = 0;
+    double avgResponseTime = 0;
+    double avgTurnaroundTime = 0;
+    double p99ResponseTime = 0;
+    double contextSwitches = 0;
+
+    double evaluate(const AlgorithmResult& result) const {
+        return avgWaitingTime * result.avgWaitingTime +
+               avgResponseTime * result.avgResponseTime +
+               avgTurnaroundTime * result.avgTurnaroundTime +
+               p99ResponseTime * result.responsePercentiles.p99 +
+               contextSwitches * result.contextSwitches;
+    }
+};
+
+struct QuantumTuning {
+    int bestQuantum = 0;
+    double bestObjective = 0;
+    AlgorithmResult bestResult;
+    map<int, double> evaluated;
+};
+
+// Bracketing search over [minQuantum, maxQuantum]: each round evaluates
+// evenly spaced quanta inside the bracket in parallel, then narrows the
+// bracket to the neighbours of the best point. Stops once the bracket is
+// exhausted, the best objective improves by less than `tolerance` (relative),
+// or `maxEvaluations` is reached. Quanta are never simulated twice.
+QuantumTuning tuneQuantum(const vector<Process>& processes, const TuningObjective& objective,
+                          int minQuantum, int maxQuantum, double tolerance, int maxEvaluations,
+                          const SwitchCost& switchCost = SwitchCost()) {
+    QuantumTuning tuning;
+    map<int, AlgorithmResult> results;
+    size_t pointsPerRound = std::max<size_t>(5, thread::hardware_concurrency() + 2);
+
+    SimOptions options;
+    options.recordGantt = false;
+    options.recordProcesses = false;
+
+    auto evaluate = [&](const vector<int>& candidates) {
+        vector<int> pending;
+        for (int q : candidates) {
+            if (!tuning.evaluated.count(q) && tuning.evaluated.size() + pending.size() < static_cast<size_t>(maxEvaluations)) {
+                pending.push_back(q);
+            }
+        }
+        vector<AlgorithmResult> batch(pending.size());
+        parallelFor(pending.size(), [&](size_t i) {
+            batch[i] = roundRobinAt(processes, pending[i], switchCost, options);
+        });
+        for (size_t i = 0; i < pending.size(); i++) {
+            tuning.evaluated[pending[i]] = objective.evaluate(batch[i]);
+            results[pending[i]] = std::move(batch[i]);
+        }
+    };
+
+    int lo = minQuantum;
+    int hi = maxQuantum;
+    double previousBest = numeric_limits<double>::infinity();
+
+    while (true) {
+        // Evenly spaced candidates including both bracket ends
+        vector<int> candidates;
+        if (static_cast<size_t>(hi - lo) + 1 <= pointsPerRound) {
+            for (int q = lo; q <= hi; q++) {
+                candidates.push_back(q);
+            }
+        } else {
+            for (size_t k = 0; k < pointsPerRound; k++) {
+                candidates.push_back(lo + static_cast<int>((static_cast<long long>(hi - lo) * k) / (pointsPerRound - 1)));
+            }
+        }
+        evaluate(candidates);
+
+        // Best evaluated quantum inside the bracket (ties go to the smaller quantum)
+        auto first = tuning.evaluated.lower_bound(lo);
+        auto last = tuning.evaluated.upper_bound(hi);
+        auto best = first;
+        for (auto it = first; it != last; ++it) {
+            if (it->second < best->second) {
+                best = it;
+            }
+        }
+
+        bool exhausted = static_cast<size_t>(hi - lo) + 1 <= pointsPerRound;
+        bool converged = std::isfinite(previousBest) &&
+                         previousBest - best->second <= tolerance * std::abs(previousBest);
+        bool outOfBudget = tuning.evaluated.size() >= static_cast<size_t>(maxEvaluations);
+        if (exhausted || converged || outOfBudget) {
+            break;
+        }
+        previousBest = best->second;
+
+        // Narrow to the evaluated neighbours of the best point
+        lo = best == first ? best->first : prev(best)->first;
+        hi = next(best) == last ? best->first : next(best)->first;
+    }
+
+    auto best = min_element(tuning.evaluated.begin(), tuning.evaluated.end(),
+                            [](const auto& a, const auto& b) { return a.second < b.second; });
+    tuning.bestQuantum = best->first;
+    tuning.bestObjective = best->second;
+    tuning.bestResult = std::move(results[best->first]);
+    return tuning;
+}
+
+// Random 16-digit hex ID for stored workloads and results
+string randomHexId(mt19937_64& gen) {
+    static const char* hex = "0123456789abcdef";
+    uint64_t value = gen();
+    string id(16, '0');
+    for (int i = 15; i >= 0; i--) {
+        id[i] = hex[value & 0xF];
+        value >>= 4;
+    }
+    return id;
+}
+
+// Workload store: parsed workloads kept in memory (LRU, bounded by bytes) and
+// optionally mirrored to disk, so clients can upload once and reference by ID
+class WorkloadStore {
+public:
+    WorkloadStore(size_t maxBytes, string directory)
+        : maxBytes(maxBytes), directory(std::move(directory)), gen(random_device{}()) {}
+
+    // Stores a workload and returns its ID. `persisted` tells whether the
+    // disk copy was written; without it the workload is lost on restart.
+    string put(vector<Process> processes, bool& persisted) {
+        auto workload = make_shared<const vector<Process>>(std::move(processes));
+
+        string id;
+        {
+            lock_guard<mutex> lock(mtx);
+            do {
+                id = randomHexId(gen);
+            } while (entries.count(id));
+            insert(id, workload);
+        }
+
+        // The workload is immutable, so it can be written without the lock
+        persisted = !directory.empty() && saveToDisk(id, *workload);
+        return id;
+    }
+
+    shared_ptr<const vector<Process>> get(const string& id) {
+        lock_guard<mutex> lock(mtx);
+        auto it = entries.find(id);
+        if (it != entries.end()) {
+            // Move to the front of the LRU list
+            lru.splice(lru.begin(), lru, it->second.lruPos);
+            return it->second.processes;
+        }
+
+        // Evicted (or stored by a previous run): fall back to the disk copy
+        if (directory.empty() || !isValidId(id)) {
+            return nullptr;
+        }
+        auto workload = loadFromDisk(id);
+        if (workload) {
+            insert(id, workload);
+        }
+        return workload;
+    }
+
+    bool remove(const string& id) {
+        lock_guard<mutex> lock(mtx);
+        bool found = false;
+        auto it = entries.find(id);
+        if (it != entries.end()) {
+            usedBytes -= it->second.bytes;
+            lru.erase(it->second.lruPos);
+            entries.erase(it);
+            found = true;
+        }
+        if (!directory.empty() && isValidId(id)) {
+            found = std::remove(filePath(id).c_str()) == 0 || found;
+        }
+        return found;
+    }
+
+    static size_t workloadBytes(const vector<Process>& processes) {
+        return sizeof(vector<Process>) + processes.size() * sizeof(Process);
+    }
+
+private:
+    struct Entry {
+        shared_ptr<const vector<Process>> processes;
+        size_t bytes;
+        list<string>::iterator lruPos;
+    };
+
+    void insert(const string& id, shared_ptr<const vector<Process>> workload) {
+        size_t bytes = workloadBytes(*workload);
+        lru.push_front(id);
+        entries[id] = Entry{std::move(workload), bytes, lru.begin()};
+        usedBytes += bytes;
+
+        // Evict least recently used workloads, but always keep the newest one
+        while (usedBytes > maxBytes && lru.size() > 1) {
+            auto victim = entries.find(lru.back());
+            usedBytes -= victim->second.bytes;
+            entries.erase(victim);
+            lru.pop_back();
+        }
+    }
+
+    static bool isValidId(const string& id) {
+        if (id.size() != 16) {
+            return false;
+        }
+        return all_of(id.begin(), id.end(), [](char c) {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+        });
+    }
+
+    string filePath(const string& id) const {
+        return directory + "/" + id + ".workload";
+    }
+
+    // File layout: magic, version, process count, then id/burst/arrival/priority
+    // (since version 2 also deadline, since version 3 also tickets) per process.
+    // Written to a temporary file and renamed, so readers never see a partial
+    // file. Returns false when the file could not be written.
+    bool saveToDisk(const string& id, const vector<Process>& processes) const {
+        string path = filePath(id);
+        string tempPath = path + ".tmp";
+        ofstream out(tempPath, ios::binary | ios::trunc);
+        if (!out) {
+            return false;
+        }
+        uint32_t header[2] = {fileMagic, fileVersion};
+        uint64_t count = processes.size();
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& p : processes) {
+            int32_t fields[6] = {p.id, p.burstTime, p.arrivalTime, p.priority, p.deadline, p.tickets};
+            out.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+        }
+        out.close();
+        if (!out || rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    shared_ptr<const vector<Process>> loadFromDisk(const string& id) const {
+        ifstream in(filePath(id), ios::binary);
+        if (!in) {
+            return nullptr;
+        }
+        uint32_t header[2];
+        uint64_t count = 0;
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!in || header[0] != fileMagic || header[1] < 1 || header[1] > fileVersion) {
+            return nullptr;
+        }
+
+        // Files that parseProcesses would reject count as unreadable
+        if (count == 0) {
+            return nullptr;
+        }
+        vector<Process> processes;
+        size_t fieldCount = header[1] + 3;
+        for (uint64_t i = 0; i < count; i++) {
+            int32_t fields[6];
+            if (!in.read(reinterpret_cast<char*>(fields), fieldCount * sizeof(int32_t))) {
+                return nullptr;
+            }
+            Process p;
+            p.id = fields[0];
+            p.burstTime = fields[1];
+            p.arrivalTime = fields[2];
+            p.priority = fields[3];
+            if (fieldCount > 4) {
+                p.deadline = fields[4];
+            }
+            if (fieldCount > 5) {
+                p.tickets = fields[5];
+            }
+            if (p.burstTime < 1 || p.arrivalTime < 0) {
+                return nullptr;
+            }
+            processes.push_back(p);
+        }
+        return make_shared<const vector<Process>>(std::move(processes));
+    }
+
+    static constexpr uint32_t fileMagic = 0x4C4B5257; // "WRKL"
+    static constexpr uint32_t fileVersion = 3;
+
+    size_t maxBytes;
+    size_t usedBytes = 0;
+    string directory;
+    mt19937_64 gen;
+    mutex mtx;
+    list<string> lru;
+    unordered_map<string, Entry> entries;
+};
+
+// Compact Gantt chart: segments in start order become tokens relative to
+// the state before them (the CPU, the gap since that CPU's last segment
+// ended, the length, the change of process ID), packed as varints. A run of
+// tokens repeating earlier ones in the block, such as a round-robin cycle,
+// becomes a single copy instruction. Every blockSegments segments the state
+// resets, so a reader can start at any block.
+//
+// Block layout, each field an unsigned LEB128 varint (zigzag for signed):
+//   literal: cpu << 1, gap, length, processId delta
+//   copy:    distance << 1 | 1, count   (repeat the `count` tokens starting
+//            `distance` back; the ranges may overlap)
+class CompactGantt {
+public:
+    static constexpr size_t blockSegments = 1024;
+
+    // One segment relative to the decoder state before it
+    struct Token {
+        int cpu = 0;
+        long long gap = 0;
+        int length = 0;
+        long long processDelta = 0;
+
+        bool operator==(const Token& other) const {
+            return cpu == other.cpu && gap == other.gap && length == other.length && processDelta == other.processDelta;
+        }
+
+        size_t hash() const {
+            uint64_t h = static_cast<uint64_t>(gap) * 0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(length) * 0xC2B2AE3D27D4EB4FULL ^
+                         static_cast<uint64_t>(processDelta) * 0x165667B19E3779F9ULL ^ static_cast<uint64_t>(cpu);
+            return static_cast<size_t>(h ^ h >> 29);
+        }
+    };
+
+    CompactGantt() = default;
+
+    // Segments must be sorted by start time for firstEndingAfter; any order
+    // round-trips
+    explicit CompactGantt(const vector<GanttEntry>& segments) : count(segments.size()) {
+        vector<Token> tokens;
+        vector<int> lastSeen(hashSize);
+        vector<int> prevEnd;
+        int latest = INT_MIN;
+        for (size_t blockStart = 0; blockStart < count; blockStart += blockSegments) {
+            size_t blockEnd = std::min(count, blockStart + blockSegments);
+            blockOffsets.push_back(stream.size());
+
+            tokens.clear();
+            prevEnd.clear();
+            int prevProcess = 0;
+            for (size_t i = blockStart; i < blockEnd; i++) {
+                const GanttEntry& segment = segments[i];
+                if (segment.cpu >= static_cast<int>(prevEnd.size())) {
+                    prevEnd.resize(segment.cpu + 1, 0);
+                }
+                tokens.push_back({segment.cpu, static_cast<long long>(segment.startTime) - prevEnd[segment.cpu],
+                                  segment.endTime - segment.startTime,
+                                  static_cast<long long>(segment.processId) - prevProcess});
+                prevEnd[segment.cpu] = segment.endTime;
+                prevProcess = segment.processId;
+                latest = std::max(latest, segment.endTime);
+            }
+            blockMaxEnd.push_back(latest);
+
+            // Greedy LZ over tokens: extend a match from the last token with the same hash
+            fill(lastSeen.begin(), lastSeen.end(), -1);
+            for (size_t i = 0; i < tokens.size();) {
+                size_t slot = tokens[i].hash() & (hashSize - 1);
+                size_t length = 0;
+                if (lastSeen[slot] >= 0) {
+                    size_t j = lastSeen[slot];
+                    while (i + length < tokens.size() && tokens[j + length] == tokens[i + length]) {
+                        length++;
+                    }
+                }
+                if (length >= minCopy) {
+                    putVarint((i - lastSeen[slot]) << 1 | 1);
+                    putVarint(length);
+                    for (size_t k = i; k < i + length; k++) {
+                        lastSeen[tokens[k].hash() & (hashSize - 1)] = static_cast<int>(k);
+                    }
+                    i += length;
+                } else {
+                    putVarint(static_cast<uint64_t>(tokens[i].cpu) << 1);
+                    putVarint(zigzag(tokens[i].gap));
+                    putVarint(tokens[i].length);
+                    putVarint(zigzag(tokens[i].processDelta));
+                    lastSeen[slot] = static_cast<int>(i);
+                    i++;
+                }
+            }
+        }
+        stream.shrink_to_fit();
+    }
+
+    size_t size() const { return count; }
+
+    size_t bytes() const {
+        return stream.size() + blockOffsets.size() * sizeof(size_t) + blockMaxEnd.size() * sizeof(int);
+    }
+
+    // Position of the first block with a segment ending after `time`: no
+    // segment before it overlaps anything from `time` on
+    size_t firstEndingAfter(long long time) const {
+        size_t block = upper_bound(blockMaxEnd.begin(), blockMaxEnd.end(), time) - blockMaxEnd.begin();
+        return std::min(count, block * blockSegments);
+    }
+
+    // Download format: "GNTC", then varints version, segment count and
+    // blockSegments, then the blocks back to back
+    string wireFormat() const {
+        string out = "GNTC";
+        for (uint64_t value : {static_cast<uint64_t>(wireVersion), static_cast<uint64_t>(count),
+                               static_cast<uint64_t>(blockSegments)}) {
+            for (; value >= 0x80; value >>= 7) {
+                out.push_back(static_cast<char>(value | 0x80));
+            }
+            out.push_back(static_cast<char>(value));
+        }
+        out.append(stream.begin(), stream.end());
+        return out;
+    }
+
+    // Streaming decoder. seek() to another block decodes from that block's
+    // start; seeking forward within the current block just skips ahead.
+    class Reader {
+    public:
+        explicit Reader(const CompactGantt& gantt, size_t position = 0) : gantt(gantt) {
+            history.reserve(blockSegments);
+            seek(position);
+        }
+
+        size_t position() const { return pos; }
+
+        void seek(size_t target) {
+            if (target >= gantt.count) {
+                pos = gantt.count;
+                return;
+            }
+            if (target < pos || target / blockSegments != pos / blockSegments) {
+                pos = target / blockSegments * blockSegments;
+            }
+            GanttEntry skipped;
+            while (pos < target) {
+                next(skipped);
+            }
+        }
+
+        bool next(GanttEntry& segment) {
+            if (pos >= gantt.count) {
+                return false;
+            }
+            if (pos % blockSegments == 0) {
+                offset = gantt.blockOffsets[pos / blockSegments];
+                history.clear();
+                prevEnd.clear();
+                prevProcess = 0;
+                copyLeft = 0;
+            }
+
+            Token token;
+            if (copyLeft == 0) {
+                uint64_t head = readVarint();
+                if (head & 1) {
+                    copyFrom = history.size() - (head >> 1);
+                    copyLeft = readVarint();
+                } else {
+                    token.cpu = static_cast<int>(head >> 1);
+                    token.gap = unzigzag(readVarint());
+                    token.length = static_cast<int>(readVarint());
+                    token.processDelta = unzigzag(readVarint());
+                }
+            }
+            if (copyLeft > 0) {
+                token = history[copyFrom++];
+                copyLeft--;
+            }
+            history.push_back(token);
+
+            if (token.cpu >= static_cast<int>(prevEnd.size())) {
+                prevEnd.resize(token.cpu + 1, 0);
+            }
+            segment.cpu = token.cpu;
+            segment.startTime = static_cast<int>(prevEnd[token.cpu] + token.gap);
+            segment.endTime = segment.startTime + token.length;
+            segment.processId = static_cast<int>(prevProcess + token.processDelta);
+            prevEnd[token.cpu] = segment.endTime;
+            prevProcess = segment.processId;
+            pos++;
+            return true;
+        }
+
+    private:
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (int shift = 0;; shift += 7) {
+                uint8_t byte = gantt.stream[offset++];
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+        }
+
+        const CompactGantt& gantt;
+        size_t pos = 0;
+        size_t offset = 0;
+        vector<Token> history;
+        size_t copyFrom = 0;
+        size_t copyLeft = 0;
+        vector<int> prevEnd;
+        int prevProcess = 0;
+    };
+
+private:
+    static constexpr size_t hashSize = 4096;
+    // Shorter repeats cost about as much as literals
+    static constexpr size_t minCopy = 2;
+    static constexpr int wireVersion = 1;
+
+    static uint64_t zigzag(long long value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static long long unzigzag(uint64_t value) {
+        return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+    }
+
+    void putVarint(uint64_t value) {
+        for (; value >= 0x80; value >>= 7) {
+            stream.push_back(static_cast<uint8_t>(value | 0x80));
+        }
+        stream.push_back(static_cast<uint8_t>(value));
+    }
+
+    vector<uint8_t> stream;
+    size_t count = 0;
+    vector<size_t> blockOffsets;
+    // Largest segment end up to and including each block
+    vector<int> blockMaxEnd;
+};
+
+// Gantt chart of a finished run, indexed for range and zoomable queries.
+// Segments are kept in start order as a CompactGantt, with a running maximum
+// of end times per block for binary search, and again in process order as a
+// second CompactGantt, with each process's range in a CSR array. On top sits a
+// pyramid of cells: level 0 cells are a power of two wide, each level above
+// merges pairs, and every cell keeps its busy and overhead time plus the
+// processes with the most CPU time in it.
+class GanttIndex {
+public:
+    static constexpr int topProcesses = 4;
+
+    // One bucket of an aggregated view; times are summed over CPUs
+    struct Bucket {
+        long long start = 0;
+        long long end = 0;
+        int dominantProcess = idleProcessId;
+        double dominantTime = 0;
+        double busy = 0;
+        double overhead = 0;
+    };
+
+    struct View {
+        bool exact = true;
+        long long cellWidth = 0; // base cell width of the pyramid (0 when exact)
+        vector<Bucket> buckets;
+    };
+
+    GanttIndex(vector<GanttEntry> ganttChart, int makespan) : makespan(makespan) {
+        for (const auto& entry : ganttChart) {
+            cpuCount = std::max(cpuCount, entry.cpu + 1);
+        }
+        // Idle time is whatever the runs and overhead leave uncovered
+        ganttChart.erase(remove_if(ganttChart.begin(), ganttChart.end(), [](const GanttEntry& entry) {
+            return entry.processId == idleProcessId || entry.endTime <= entry.startTime;
+        }), ganttChart.end());
+        stable_sort(ganttChart.begin(), ganttChart.end(), [](const GanttEntry& a, const GanttEntry& b) {
+            return a.startTime < b.startTime;
+        });
+
+        buildProcessLists(ganttChart);
+        segments = CompactGantt(ganttChart);
+        vector<GanttEntry>().swap(ganttChart);
+        buildPyramid();
+    }
+
+    int cpus() const { return cpuCount; }
+    size_t segmentCount() const { return segments.size(); }
+    const CompactGantt& compact() const { return segments; }
+
+    size_t bytes() const {
+        size_t total = sizeof(GanttIndex) + segments.bytes() + processIds.size() * sizeof(int) + processOffsets.size() * sizeof(uint32_t) +
+                       processSegments.bytes();
+        for (const auto& level : levels) {
+            total += level.size() * sizeof(Cell);
+        }
+        return total;
+    }
+
+    // Appends up to `limit` segments overlapping [start, end) in start order,
+    // resuming at position `cursor` (0 for the first page). Returns the
+    // position of the next match, or segmentCount() when there is none.
+    // The scan starts at the first block with a segment ending after `start`.
+    size_t segmentsIn(long long start, long long end, size_t cursor, size_t limit, vector<GanttEntry>& out) const {
+        CompactGantt::Reader reader(segments, std::max(cursor, segments.firstEndingAfter(start)));
+        GanttEntry segment;
+        while (reader.next(segment) && segment.startTime < end) {
+            if (segment.endTime <= start) {
+                continue;
+            }
+            if (out.size() == limit) {
+                return reader.position() - 1;
+            }
+            out.push_back(segment);
+        }
+        return segments.size();
+    }
+
+    // Number of segments (runs only) of a process
+    size_t processSegmentCount(int processId) const {
+        size_t p = processRank(processId);
+        return p == processIds.size() ? 0 : processOffsets[p + 1] - processOffsets[p];
+    }
+
+    // Appends up to `limit` segments of a process in time order, starting at
+    // its `cursor`-th one. Returns the cursor of the next page. The page is
+    // contiguous in processSegments: one seek, then a sequential decode.
+    size_t processSegmentsFrom(int processId, size_t cursor, size_t limit, vector<GanttEntry>& out) const {
+        size_t p = processRank(processId);
+        if (p == processIds.size()) {
+            return 0;
+        }
+        size_t from = std::min<size_t>(processOffsets[p] + cursor, processOffsets[p + 1]);
+        size_t to = std::min<size_t>(from + limit, processOffsets[p + 1]);
+        CompactGantt::Reader reader(processSegments, from);
+        GanttEntry segment;
+        for (size_t k = from; k < to && reader.next(segment); k++) {
+            out.push_back(segment);
+        }
+        return to - processOffsets[p];
+    }
+
+    // Splits [start, end) into `count` buckets (end <= makespan, count <= end - start).
+    // Buckets at least coarseCells base cells wide are summed from the
+    // largest aligned cells that fit, as in a segment tree, prorating only
+    // the base cells cut by bucket edges: O(count * levels) however many
+    // segments the window holds. Narrower buckets come exactly from the segments.
+    View aggregate(long long start, long long end, int count) const {
+        View view;
+        view.buckets.resize(count);
+        long long length = end - start;
+        auto bound = [&](long long b) { return start + length * b / count; };
+        for (int b = 0; b < count; b++) {
+            view.buckets[b].start = bound(b);
+            view.buckets[b].end = bound(b + 1);
+        }
+
+        long long narrowest = length / count;
+        if (narrowest < cellWidth * coarseCells) {
+            aggregateExact(view, start, end);
+            return view;
+        }
+
+        view.exact = false;
+        view.cellWidth = cellWidth;
+
+        vector<Share> shares;
+        for (auto& bucket : view.buckets) {
+            shares.clear();
+            for (long long time = bucket.start; time < bucket.end;) {
+                // Largest cell starting at `time` that ends within the bucket
+                size_t level = 0;
+                while (level + 1 < levels.size() && time % (cellWidth << (level + 1)) == 0 &&
+                       std::min<long long>(time + (cellWidth << (level + 1)), makespan) <= bucket.end) {
+                    level++;
+                }
+                long long width = cellWidth << level;
+                const Cell& cell = levels[level][time / width];
+                long long cellStart = time / width * width;
+                long long cellEnd = std::min<long long>(cellStart + width, makespan);
+                long long pieceEnd = std::min(bucket.end, cellEnd);
+                double fraction = static_cast<double>(pieceEnd - time) / (cellEnd - cellStart);
+                time = pieceEnd;
+                bucket.busy += cell.busy * fraction;
+                bucket.overhead += cell.overhead * fraction;
+                for (const auto& share : cell.top) {
+                    if (share.time == 0) {
+                        break;
+                    }
+                    auto it = find_if(shares.begin(), shares.end(), [&](const Share& s) {
+                        return s.processId == share.processId;
+                    });
+                    if (it == shares.end()) {
+                        shares.push_back({share.processId, 0});
+                        it = shares.end() - 1;
+                    }
+                    it->time += share.time * fraction;
+                }
+            }
+            for (const auto& share : shares) {
+                if (share.time > bucket.dominantTime) {
+                    bucket.dominantProcess = share.processId;
+                    bucket.dominantTime = share.time;
+                }
+            }
+        }
+        return view;
+    }
+
+private:
+    // Level 0 holds about one cell per baseSegmentsPerCell segments, within
+    // [minBaseCells, maxBaseCells]
+    static constexpr size_t baseSegmentsPerCell = 32;
+    static constexpr size_t minBaseCells = 1024;
+    static constexpr size_t maxBaseCells = 1 << 20;
+    // Pyramid buckets span at least this many base cells, bounding the
+    // error from prorating the two cells at their edges
+    static constexpr long long coarseCells = 16;
+
+    struct Share {
+        int processId = idleProcessId;
+        double time = 0;
+    };
+
+    struct Cell {
+        long long busy = 0;
+        long long overhead = 0;
+        array<Share, topProcesses> top;
+    };
+
+    // Position of processId in processIds, or processIds.size() when absent
+    size_t processRank(int processId) const {
+        auto it = lower_bound(processIds.begin(), processIds.end(), processId);
+        return it != processIds.end() && *it == processId ? it - processIds.begin() : processIds.size();
+    }
+
+    // Groups run segments by process (CSR: the segments of processIds[p] are
+    // processSegments[processOffsets[p] .. processOffsets[p + 1]))
+    void buildProcessLists(const vector<GanttEntry>& segments) {
+        // Keys of process and position sort by process, then time order
+        vector<uint64_t> keys;
+        for (uint32_t i = 0; i < segments.size(); i++) {
+            if (segments[i].processId >= 0) {
+                keys.push_back(static_cast<uint64_t>(segments[i].processId) << 32 | i);
+            }
+        }
+        sort(keys.begin(), keys.end());
+        vector<GanttEntry> byProcess(keys.size());
+        for (size_t k = 0; k < keys.size(); k++) {
+            int processId = static_cast<int>(keys[k] >> 32);
+            byProcess[k] = segments[static_cast<uint32_t>(keys[k])];
+            if (processIds.empty() || processIds.back() != processId) {
+                processIds.push_back(processId);
+                processOffsets.push_back(static_cast<uint32_t>(k));
+            }
+        }
+        processOffsets.push_back(static_cast<uint32_t>(keys.size()));
+        processSegments = CompactGantt(byProcess);
+    }
+
+    // Sums shares of the same process and keeps the largest in cell.top
+    static void keepTop(vector<Share>& shares, Cell& cell) {
+        sort(shares.begin(), shares.end(), [](const Share& a, const Share& b) {
+            return a.processId < b.processId;
+        });
+        size_t merged = 0;
+        for (size_t i = 0; i < shares.size(); i++) {
+            if (merged > 0 && shares[merged - 1].processId == shares[i].processId) {
+                shares[merged - 1].time += shares[i].time;
+            } else {
+                shares[merged++] = shares[i];
+            }
+        }
+        shares.resize(merged);
+        size_t kept = std::min<size_t>(merged, topProcesses);
+        partial_sort(shares.begin(), shares.begin() + kept, shares.end(), [](const Share& a, const Share& b) {
+            return a.time != b.time ? a.time > b.time : a.processId < b.processId;
+        });
+        copy(shares.begin(), shares.begin() + kept, cell.top.begin());
+    }
+
+    void buildPyramid() {
+        size_t maxCells = std::clamp(segments.size() / baseSegmentsPerCell, minBaseCells, maxBaseCells);
+        while ((makespan + cellWidth - 1) / cellWidth > static_cast<long long>(maxCells)) {
+            cellWidth *= 2;
+        }
+
+        // Sweep the cells in time order; at most one segment per CPU spans
+        // past a cell end, so the active list stays short
+        vector<Cell> base((makespan + cellWidth - 1) / cellWidth);
+        vector<GanttEntry> active;
+        vector<Share> shares;
+        CompactGantt::Reader reader(segments);
+        GanttEntry next;
+        bool hasNext = reader.next(next);
+        for (size_t c = 0; c < base.size(); c++) {
+            long long cellStart = c * cellWidth;
+            long long cellEnd = std::min<long long>(cellStart + cellWidth, makespan);
+            while (hasNext && next.startTime < cellEnd) {
+                active.push_back(next);
+                hasNext = reader.next(next);
+            }
+            shares.clear();
+            for (const GanttEntry& segment : active) {
+                long long time = std::min<long long>(segment.endTime, cellEnd) - std::max<long long>(segment.startTime, cellStart);
+                if (segment.processId >= 0) {
+                    base[c].busy += time;
+                    shares.push_back({segment.processId, static_cast<double>(time)});
+                } else {
+                    base[c].overhead += time;
+                }
+            }
+            keepTop(shares, base[c]);
+            active.erase(remove_if(active.begin(), active.end(), [&](const GanttEntry& segment) {
+                return segment.endTime <= cellEnd;
+            }), active.end());
+        }
+        levels.push_back(std::move(base));
+
+        while (levels.back().size() > 1) {
+            const vector<Cell>& below = levels.back();
+            vector<Cell> above((below.size() + 1) / 2);
+            for (size_t c = 0; c < above.size(); c++) {
+                shares.clear();
+                for (size_t k = 2 * c; k < std::min(2 * c + 2, below.size()); k++) {
+                    above[c].busy += below[k].busy;
+                    above[c].overhead += below[k].overhead;
+                    for (const auto& share : below[k].top) {
+                        if (share.time > 0) {
+                            shares.push_back(share);
+                        }
+                    }
+                }
+                keepTop(shares, above[c]);
+            }
+            levels.push_back(std::move(above));
+        }
+    }
+
+    // Sums every segment piece into its bucket; per-process time goes
+    // through one flat list sorted by bucket and process at the end
+    void aggregateExact(View& view, long long start, long long end) const {
+        struct Piece {
+            int bucket;
+            int processId;
+            long long time;
+        };
+        vector<Piece> pieces;
+        int count = static_cast<int>(view.buckets.size());
+        CompactGantt::Reader reader(segments, segments.firstEndingAfter(start));
+        GanttEntry segment;
+        while (reader.next(segment) && segment.startTime < end) {
+            long long from = std::max<long long>(segment.startTime, start);
+            long long to = std::min<long long>(segment.endTime, end);
+            if (from >= to) {
+                continue;
+            }
+            int b = static_cast<int>((from - start) * count / (end - start));
+            while (b + 1 < count && view.buckets[b + 1].start <= from) {
+                b++;
+            }
+            for (; b < count && view.buckets[b].start < to; b++) {
+                Bucket& bucket = view.buckets[b];
+                long long time = std::min(to, bucket.end) - std::max(from, bucket.start);
+                if (segment.processId >= 0) {
+                    bucket.busy += time;
+                    pieces.push_back({b, segment.processId, time});
+                } else {
+                    bucket.overhead += time;
+                }
+            }
+        }
+
+        sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) {
+            return a.bucket != b.bucket ? a.bucket < b.bucket : a.processId < b.processId;
+        });
+        for (size_t i = 0; i < pieces.size();) {
+            size_t j = i;
+            long long time = 0;
+            for (; j < pieces.size() && pieces[j].bucket == pieces[i].bucket && pieces[j].processId == pieces[i].processId; j++) {
+                time += pieces[j].time;
+            }
+            Bucket& bucket = view.buckets[pieces[i].bucket];
+            if (time > bucket.dominantTime) {
+                bucket.dominantProcess = pieces[i].processId;
+                bucket.dominantTime = static_cast<double>(time);
+            }
+            i = j;
+        }
+    }
+
+    CompactGantt segments;
+    vector<int> processIds;
+    vector<uint32_t> processOffsets;
+    CompactGantt processSegments;
+    long long makespan;
+    int cpuCount = 1;
+    long long cellWidth = 1;
+    vector<vector<Cell>> levels;
+};
+
+// A finished run kept server-side under a result ID
+struct StoredResult {
+    string name;
+    int makespan;
+    GanttIndex gantt;
+    vector<ProcessMetrics> processes;
+};
+
+// Result store: finished runs kept in memory (LRU, bounded by bytes) so
+// clients can query their Gantt charts instead of downloading them whole
+class ResultStore {
+public:
+    explicit ResultStore(size_t maxBytes) : maxBytes(maxBytes), gen(random_device{}()) {}
+
+    string put(shared_ptr<const StoredResult> result) {
+        size_t bytes = resultBytes(*result);
+
+        lock_guard<mutex> lock(mtx);
+        string id;
+        do {
+            id = randomHexId(gen);
+        } while (entries.count(id));
+
+        lru.push_front(id);
+        entries[id] = Entry{std::move(result), bytes, lru.begin()};
+        usedBytes += bytes;
+
+        // Evict least recently used results, but always keep the newest one
+        while (usedBytes > maxBytes && lru.size() > 1) {
+            auto victim = entries.find(lru.back());
+            usedBytes -= victim->second.bytes;
+            entries.erase(victim);
+            lru.pop_back();
+        }
+        return id;
+    }
+
+    shared_ptr<const StoredResult> get(const string& id) {
+        lock_guard<mutex> lock(mtx);
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        lru.splice(lru.begin(), lru, it->second.lruPos);
+        return it->second.result;
+    }
+
+    bool remove(const string& id) {
+        lock_guard<mutex> lock(mtx);
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            return false;
+        }
+        usedBytes -= it->second.bytes;
+        lru.erase(it->second.lruPos);
+        entries.erase(it);
+        return true;
+    }
+
+    static size_t resultBytes(const StoredResult& result) {
+        return sizeof(StoredResult) + result.gantt.bytes() + result.processes.size() * sizeof(ProcessMetrics);
+    }
+
+private:
+    struct Entry {
+        shared_ptr<const StoredResult> result;
+        size_t bytes;
+        list<string>::iterator lruPos;
+    };
+
+    size_t maxBytes;
+    size_t usedBytes = 0;
+    mt19937_64 gen;
+    mutex mtx;
+    list<string> lru;
+    unordered_map<string, Entry> entries;
+};
+
+// Returns an error message, or an empty string when every process is well formed
+string parseProcesses(const crow::json::rvalue& items, vector<Process>& processes) {
+    if (items.size() == 0) {
+        return "Workload has no processes";
+    }
+    processes.reserve(items.size());
+    for (const auto& item : items) {
+        Process p;
+        p.id = item["id"].i();
+        p.burstTime = item["burstTime"].i();
+        p.arrivalTime = item["arrivalTime"].i();
+        p.priority = item["priority"].i();
+        if (p.burstTime < 1) {
+            return "burstTime must be at least 1 (process " + to_string(p.id) + ")";
+        }
+        if (p.arrivalTime < 0) {
+            return "arrivalTime must not be negative (process " + to_string(p.id) + ")";
+        }
+        if (item.has("deadline")) {
+            p.deadline = item["deadline"].i();
+        }
+        if (item.has("tickets")) {
+            p.tickets = static_cast<int>(item["tickets"].i());
+            if (p.tickets < 1) {
+                return "tickets must be at least 1 (process " + to_string(p.id) + ")";
+            }
+        }
+        processes.push_back(p);
+    }
+    return "";
+}
+
+// "switchCost": {"fixed": F, "migration": M, "cacheWarmup": W}
+string parseSwitchCost(const crow::json::rvalue& params, SwitchCost& switchCost) {
+    if (!params.has("switchCost")) {
+        return "";
+    }
+    const auto& config = params["switchCost"];
+    if (config.has("fixed")) {
+        switchCost.fixed = config["fixed"].i();
+    }
+    if (config.has("migration")) {
+        switchCost.migration = config["migration"].i();
+    }
+    if (config.has("cacheWarmup")) {
+        switchCost.cacheWarmup = config["cacheWarmup"].i();
+    }
+    if (switchCost.fixed < 0 || switchCost.migration < 0 || switchCost.cacheWarmup < 0) {
+        return "switchCost values must not be negative";
+    }
+    return "";
+}
+
+// Reads the engine parameters shared by /api/schedule and the batch endpoint.
+// Returns an error message, or an empty string when the parameters are valid.
+string parseAlgorithmParams(const crow::json::rvalue& params, AlgorithmParams& algorithmParams) {
+    if (params.has("timeQuantum")) {
+        algorithmParams.timeQuantum = params["timeQuantum"].i();
+    }
+    if (algorithmParams.timeQuantum < 1) {
+        return "timeQuantum must be at least 1";
+    }
+    if (params.has("cpus")) {
+        algorithmParams.cpus = params["cpus"].i();
+    }
+    if (algorithmParams.cpus < 1 || algorithmParams.cpus > 4096) {
+        return "cpus must be between 1 and 4096";
+    }
+    if (params.has("queueMode")) {
+        string mode = params["queueMode"].s();
+        if (mode != "global" && mode != "perCpu") {
+            return "queueMode must be \"global\" or \"perCpu\"";
+        }
+        algorithmParams.globalQueue = mode == "global";
+    }
+    if (params.has("workStealing")) {
+        algorithmParams.workStealing = params["workStealing"].b();
+    }
+
+    // "mlfq": {"levels": L, "quanta": [...], "boostInterval": S}. Missing
+    // quanta double the previous level's, starting from timeQuantum.
+    MlfqConfig& mlfq = algorithmParams.mlfq;
+    int levels = 3;
+    mlfq.quanta.clear();
+    if (params.has("mlfq")) {
+        const auto& config = params["mlfq"];
+        if (config.has("quanta")) {
+            for (const auto& q : config["quanta"]) {
+                mlfq.quanta.push_back(q.i());
+            }
+            levels = static_cast<int>(mlfq.quanta.size());
+        }
+        if (config.has("levels")) {
+            levels = config["levels"].i();
+        }
+        if (config.has("boostInterval")) {
+            mlfq.boostInterval = config["boostInterval"].i();
+        }
+    }
+    if (levels < 1 || levels > 64) {
+        return "mlfq.levels must be between 1 and 64";
+    }
+    mlfq.quanta.resize(levels, 0);
+    for (int level = 0; level < levels; level++) {
+        if (mlfq.quanta[level] == 0) {
+            mlfq.quanta[level] = level == 0 ? algorithmParams.timeQuantum : 2 * mlfq.quanta[level - 1];
+        }
+        if (mlfq.quanta[level] < 1) {
+            return "mlfq.quanta must be at least 1";
+        }
+    }
+    if (mlfq.boostInterval < 0) {
+        return "mlfq.boostInterval must not be negative";
+    }
+
+    // "cfs": {"targetLatency": T, "minGranularity": G}
+    if (params.has("cfs")) {
+        const auto& config = params["cfs"];
+        if (config.has("targetLatency")) {
+            algorithmParams.cfs.targetLatency = config["targetLatency"].i();
+        }
+        if (config.has("minGranularity")) {
+            algorithmParams.cfs.minGranularity = config["minGranularity"].i();
+        }
+    }
+    if (algorithmParams.cfs.targetLatency < 1 || algorithmParams.cfs.minGranularity < 1) {
+        return "cfs.targetLatency and cfs.minGranularity must be at least 1";
+    }
+    string switchCostError = parseSwitchCost(params, algorithmParams.switchCost);
+    if (!switchCostError.empty()) {
+        return switchCostError;
+    }
+    if (params.has("agingRate")) {
+        algorithmParams.agingRate = params["agingRate"].d();
+    }
+    if (algorithmParams.agingRate < 0) {
+        return "agingRate must not be negative";
+    }
+    // The SMP core orders its run queues by plain priority
+    if (algorithmParams.agingRate > 0 && usesSmpCore(algorithmParams)) {
+        return "agingRate is not supported with cpus > 1 or switchCost";
+    }
+    if (params.has("lotterySeed")) {
+        algorithmParams.lotterySeed = static_cast<uint64_t>(params["lotterySeed"].i());
+    }
+    return "";
+}
+
+// The CPU/I-O engine runs one CPU without switch costs or aging, so of the
+// engine parameters only timeQuantum applies to it
+string checkIoEngineParams(const crow::json::rvalue& params, const AlgorithmParams& algorithmParams) {
+    if (algorithmParams.cpus > 1 || params.has("queueMode") || params.has("workStealing") ||
+        algorithmParams.switchCost.enabled() || algorithmParams.agingRate > 0) {
+        return "The I/O engine does not support cpus > 1, queueMode, workStealing, switchCost or agingRate";
+    }
+    return "";
+}
+
+// Per-run outputs: "starvationThreshold", "details" (false drops the Gantt
+// chart and per-process rows), "timelineBucket" and "timelinePoints"
+string parseSimOptions(const crow::json::rvalue& params, SimOptions& options) {
+    if (params.has("starvationThreshold")) {
+        options.starvationThreshold = params["starvationThreshold"].i();
+    }
+    if (options.starvationThreshold < 0) {
+        return "starvationThreshold must not be negative";
+    }
+    // Aggregates, percentiles and fairness are complete without the Gantt
+    // chart and per-process rows, which large runs can skip
+    if (params.has("details") && !params["details"].b()) {
+        options.recordGantt = false;
+        options.recordProcesses = false;
+    }
+    if (params.has("timelineBucket")) {
+        options.timelineBucket = params["timelineBucket"].i();
+    }
+    if (options.timelineBucket < 0) {
+        return "timelineBucket must not be negative";
+    }
+    if (params.has("timelinePoints")) {
+        options.timelinePoints = params["timelinePoints"].i();
+    }
+    if (options.timelinePoints < 1 || options.timelinePoints > maxTimelinePoints) {
+        return "timelinePoints must be between 1 and " + to_string(maxTimelinePoints);
+    }
+    return "";
+}
+
+// Per-process fields of a response, selectable with "fields"
+enum ProcessField {
+    fieldId,
+    fieldArrivalTime,
+    fieldBurstTime,
+    fieldPriority,
+    fieldCompletionTime,
+    fieldTurnaroundTime,
+    fieldWaitingTime,
+    fieldResponseTime,
+    fieldCpuTime,
+    fieldDispatches,
+    fieldPreemptions,
+    fieldDeadline,
+    fieldLateness,
+    fieldTickets,
+    fieldIdealService,
+    fieldShareError,
+    fieldMaxLag,
+    processFieldCount
+};
+
+const char* const processFieldNames[processFieldCount] = {
+    "id", "arrivalTime", "burstTime", "priority", "completionTime", "turnaroundTime",
+    "waitingTime", "responseTime", "cpuTime", "dispatches", "preemptions", "deadline",
+    "lateness", "tickets", "idealService", "shareError", "maxLag"};
+
+const uint32_t allProcessFields = (1u << processFieldCount) - 1;
+
+// Bit mask of the named per-process fields; returns the first unknown name
+string processFieldMask(const vector<string>& names, uint32_t& mask) {
+    mask = 0;
+    for (const auto& name : names) {
+        auto it = find_if(begin(processFieldNames), end(processFieldNames), [&](const char* field) {
+            return name == field;
+        });
+        if (it == end(processFieldNames)) {
+            return name;
+        }
+        mask |= 1u << (it - begin(processFieldNames));
+    }
+    return "";
+}
+
+// Which parts of each result a response carries: "include" lists the
+// sections ("summary", "gantt", "processes"; default all), "fields" the
+// per-process fields, and "processCursor"/"processLimit" page the rows
+struct ResponseShape {
+    bool summary = true;
+    bool gantt = true;
+    bool processes = true;
+    uint32_t processFields = allProcessFields;
+    size_t processCursor = 0;
+    size_t processLimit = SIZE_MAX;
+};
+
+string parseResponseShape(const crow::json::rvalue& params, ResponseShape& shape) {
+    if (params.has("include")) {
+        shape.summary = shape.gantt = shape.processes = false;
+        for (const auto& item : params["include"]) {
+            string section = item.s();
+            if (section == "summary") {
+                shape.summary = true;
+            } else if (section == "gantt") {
+                shape.gantt = true;
+            } else if (section == "processes") {
+                shape.processes = true;
+            } else {
+                return "Unknown include section: " + section;
+            }
+        }
+    }
+    if (params.has("fields")) {
+        vector<string> names;
+        for (const auto& item : params["fields"]) {
+            names.push_back(item.s());
+        }
+        string unknown = processFieldMask(names, shape.processFields);
+        if (!unknown.empty()) {
+            return "Unknown process field: " + unknown;
+        }
+    }
+    if (params.has("processCursor")) {
+        if (params["processCursor"].i() < 0) {
+            return "processCursor must not be negative";
+        }
+        shape.processCursor = static_cast<size_t>(params["processCursor"].i());
+    }
+    if (params.has("processLimit")) {
+        if (params["processLimit"].i() < 0) {
+            return "processLimit must not be negative";
+        }
+        shape.processLimit = static_cast<size_t>(params["processLimit"].i());
+    }
+    return "";
+}
+
+// Processes with CPU/I-O burst sequences: "bursts": [cpu, io, cpu, ...] and
+// optionally "devices": [device of each I/O burst] (default 0). Processes
+// without "bursts" run burstTime as a single CPU burst.
+string parseBurstWorkload(const crow::json::rvalue& items, int deviceCount, vector<Process>& processes,
+                          BurstTrace& trace) {
+    if (items.size() == 0) {
+        return "Workload has no processes";
+    }
+    processes.reserve(items.size());
+    trace.start.reserve(items.size() + 1);
+    for (const auto& item : items) {
+        Process p;
+        p.id = item["id"].i();
+        p.arrivalTime = item["arrivalTime"].i();
+        p.priority = item.has("priority") ? static_cast<int>(item["priority"].i()) : 0;
+        processes.push_back(p);
+
+        size_t first = trace.lengths.size();
+        if (item.has("bursts")) {
+            for (const auto& burst : item["bursts"]) {
+                trace.lengths.push_back(burst.i());
+            }
+        } else {
+            trace.lengths.push_back(item["burstTime"].i());
+        }
+        trace.devices.resize(trace.lengths.size(), 0);
+        if (trace.lengths.size() == first) {
+            return "Process " + to_string(p.id) + " has no bursts";
+        }
+
+        size_t ioBurst = 0;
+        for (size_t k = first; k < trace.lengths.size(); k++) {
+            if (trace.lengths[k] < 1) {
+                return "Burst lengths must be at least 1";
+            }
+            bool io = (k - first) % 2 == 1;
+            if (io && item.has("devices") && ioBurst < item["devices"].size()) {
+                trace.devices[k] = item["devices"][ioBurst++].i();
+            }
+            if (trace.devices[k] < 0 || trace.devices[k] >= deviceCount) {
+                return "Device out of range for process " + to_string(p.id);
+            }
+        }
+        trace.start.push_back(static_cast<int>(trace.lengths.size()));
+    }
+    return "";
+}
+
+// CPU policies of the CPU/I-O endpoints, by "algorithms" key
+const vector<pair<const char*, IoPolicy>>& ioPolicies() {
+    static const vector<pair<const char*, IoPolicy>> policies = {
+        {"fcfs", IoPolicy::Fcfs},
+        {"roundRobin", IoPolicy::RoundRobin},
+        {"srtn", IoPolicy::Srtn},
+        {"priorityPreemptive", IoPolicy::PriorityPreemptive},
+    };
+    return policies;
+}
+
+// "groups": [{"model": "cpuBound" | "ioBound" | "interactive" | "pipeline",
+// "count", "firstArrival", "arrivalInterval", "priority", "iterations",
+// "cpu", "io", "device", "think", "work"}, ...]
+string parseModelWorkload(const crow::json::rvalue& params, int deviceCount, ModelWorkload& workload) {
+    if (params.has("seed")) {
+        workload.seed = static_cast<uint64_t>(params["seed"].i());
+    }
+    long long total = 0;
+    for (const auto& item : params["groups"]) {
+        ModelGroup group;
+        group.model = item["model"].s();
+        if (group.model != "cpuBound" && group.model != "ioBound" && group.model != "interactive" &&
+            group.model != "pipeline") {
+            return "Unknown model: " + group.model;
+        }
+        auto read = [&item](const char* key, int& value) {
+            if (item.has(key)) {
+                value = item[key].i();
+            }
+        };
+        read("count", group.count);
+        read("firstArrival", group.firstArrival);
+        read("arrivalInterval", group.arrivalInterval);
+        read("priority", group.priority);
+        read("iterations", group.iterations);
+        read("cpu", group.cpu);
+        read("io", group.io);
+        read("device", group.device);
+        read("think", group.think);
+        read("work", group.work);
+        if (group.count < 0 || group.firstArrival < 0 || group.arrivalInterval < 0 || group.iterations < 0 ||
+            group.cpu < 1 || group.io < 1 || group.think < 1 || group.work < 0) {
+            return "Invalid parameters for model " + group.model;
+        }
+        if (group.device < 0 || group.device >= deviceCount) {
+            return "Device out of range for model " + group.model;
+        }
+        total += static_cast<long long>(group.count) * (group.model == "pipeline" ? 2 : 1);
+        workload.groups.push_back(group);
+    }
+    if (total < 1 || total > maxModelProcesses) {
+        return "Expected between 1 and " + to_string(maxModelProcesses) + " processes";
+    }
+    workload.expand();
+    return "";
+}
+
+// {"waitingTime": {"p50", "p90", "p99", "p999", "max"}, "responseTime": ..., "turnaroundTime": ...}
+crow::json::wvalue latencyJson(const AlgorithmResult& r) {
+    auto percentilesJson = [](const LatencyPercentiles& percentiles) {
+        crow::json::wvalue json;
+        json["p50"] = percentiles.p50;
+        json["p90"] = percentiles.p90;
+        json["p99"] = percentiles.p99;
+        json["p999"] = percentiles.p999;
+        json["max"] = percentiles.max;
+        return json;
+    };
+    crow::json::wvalue json;
+    json["waitingTime"] = percentilesJson(r.waitingPercentiles);
+    json["responseTime"] = percentilesJson(r.responsePercentiles);
+    json["turnaroundTime"] = percentilesJson(r.turnaroundPercentiles);
+    return json;
+}
+
+// {"jainIndex", "meanSlowdown", "maxSlowdown", "classes": [{"minPriority", "maxPriority", ...}]}
+crow::json::wvalue fairnessJson(const FairnessStats& fairness) {
+    crow::json::wvalue json;
+    json["jainIndex"] = fairness.jainIndex;
+    json["meanSlowdown"] = fairness.meanSlowdown;
+    json["maxSlowdown"] = fairness.maxSlowdown;
+    crow::json::wvalue classes = crow::json::wvalue::list();
+    for (size_t i = 0; i < fairness.classes.size(); i++) {
+        const PriorityClassStats& stats = fairness.classes[i];
+        crow::json::wvalue entry;
+        entry["minPriority"] = stats.minPriority;
+        entry["maxPriority"] = stats.maxPriority;
+        entry["jobs"] = stats.jobs;
+        entry["avgWaitingTime"] = stats.avgWaitingTime;
+        entry["avgResponseTime"] = stats.avgResponseTime;
+        entry["avgTurnaroundTime"] = stats.avgTurnaroundTime;
+        entry["meanSlowdown"] = stats.meanSlowdown;
+        entry["maxSlowdown"] = stats.maxSlowdown;
+        entry["maxWaitingTime"] = stats.maxWaitingTime;
+        classes[i] = std::move(entry);
+    }
+    json["classes"] = std::move(classes);
+    return json;
+}
+
+crow::json::wvalue ganttJson(const vector<GanttEntry>& ganttChart) {
+    crow::json::wvalue json = crow::json::wvalue::list();
+    for (size_t j = 0; j < ganttChart.size(); j++) {
+        crow::json::wvalue entry;
+        entry["processId"] = ganttChart[j].processId;
+        entry["startTime"] = ganttChart[j].startTime;
+        entry["endTime"] = ganttChart[j].endTime;
+        entry["cpu"] = ganttChart[j].cpu;
+        json[j] = std::move(entry);
+    }
+    return json;
+}
+
+// One per-process row, limited to the fields in the mask
+crow::json::wvalue processJson(const ProcessMetrics& pm, uint32_t fields) {
+    auto wants = [&](ProcessField field) { return (fields >> field & 1) != 0; };
+    crow::json::wvalue json;
+    if (wants(fieldId)) {
+        json["id"] = pm.id;
+    }
+    if (wants(fieldArrivalTime)) {
+        json["arrivalTime"] = pm.arrivalTime;
+    }
+    if (wants(fieldBurstTime)) {
+        json["burstTime"] = pm.burstTime;
+    }
+    if (wants(fieldPriority)) {
+        json["priority"] = pm.priority;
+    }
+    if (wants(fieldCompletionTime)) {
+        json["completionTime"] = pm.completionTime;
+    }
+    if (wants(fieldTurnaroundTime)) {
+        json["turnaroundTime"] = pm.turnaroundTime;
+    }
+    if (wants(fieldWaitingTime)) {
+        json["waitingTime"] = pm.waitingTime;
+    }
+    if (wants(fieldResponseTime)) {
+        json["responseTime"] = pm.responseTime;
+    }
+    if (wants(fieldCpuTime)) {
+        json["cpuTime"] = pm.burstTime;
+    }
+    if (wants(fieldDispatches)) {
+        json["dispatches"] = pm.dispatches;
+    }
+    if (wants(fieldPreemptions)) {
+        json["preemptions"] = pm.preemptions;
+    }
+    if (pm.deadline != noDeadline) {
+        if (wants(fieldDeadline)) {
+            json["deadline"] = pm.deadline;
+        }
+        if (wants(fieldLateness)) {
+            json["lateness"] = pm.completionTime - pm.deadline;
+        }
+    }
+    if (pm.tickets > 0) {
+        if (wants(fieldTickets)) {
+            json["tickets"] = pm.tickets;
+        }
+        if (wants(fieldIdealService)) {
+            json["idealService"] = pm.idealService;
+        }
+        if (wants(fieldShareError) && pm.idealService > 0) {
+            json["shareError"] = (pm.burstTime - pm.idealService) / pm.idealService;
+        }
+        if (wants(fieldMaxLag)) {
+            json["maxLag"] = pm.maxLag;
+        }
+    }
+    return json;
+}
+
+// {"bucketWidth", "utilization": [...], "readyQueue": [...]}
+crow::json::wvalue timelineJson(const Timeline& timeline) {
+    crow::json::wvalue json;
+    json["bucketWidth"] = timeline.bucketWidth;
+    crow::json::wvalue utilization = crow::json::wvalue::list();
+    crow::json::wvalue readyQueue = crow::json::wvalue::list();
+    for (size_t k = 0; k < timeline.utilization.size(); k++) {
+        utilization[k] = timeline.utilization[k];
+        readyQueue[k] = timeline.readyQueue[k];
+    }
+    json["utilization"] = std::move(utilization);
+    json["readyQueue"] = std::move(readyQueue);
+    return json;
+}
+
+// Aggregate metrics of a result (the "summary" section)
+void addSummaryJson(crow::json::wvalue& result, const AlgorithmResult& r) {
+    result["avgTurnaroundTime"] = r.avgTurnaroundTime;
+    result["avgWaitingTime"] = r.avgWaitingTime;
+    result["avgResponseTime"] = r.avgResponseTime;
+    result["avgCompletionTime"] = r.avgCompletionTime;
+    result["throughput"] = r.throughput;
+    result["contextSwitches"] = r.contextSwitches;
+    result["migrations"] = r.migrations;
+    result["preemptions"] = r.preemptions;
+    result["overheadTime"] = r.overheadTime;
+    result["cpuUtilization"] = r.cpuUtilization;
+    result["idleTime"] = r.idleTime;
+    if (r.timeline.bucketWidth > 0) {
+        result["timeline"] = timelineJson(r.timeline);
+    }
+    result["p99ResponseTime"] = r.responsePercentiles.p99;
+    result["maxWaitingTime"] = r.waitingPercentiles.max;
+    result["percentiles"] = latencyJson(r);
+    result["fairness"] = fairnessJson(r.fairness);
+
+    crow::json::wvalue starvationJson;
+    starvationJson["threshold"] = r.starvation.threshold;
+    starvationJson["starved"] = r.starvation.starved;
+    result["starvation"] = std::move(starvationJson);
+
+    const DeadlineStats& deadlines = r.deadlines;
+    if (deadlines.jobs > 0) {
+        crow::json::wvalue deadlineJson;
+        deadlineJson["jobs"] = deadlines.jobs;
+        deadlineJson["missed"] = deadlines.missed;
+        deadlineJson["meanLateness"] = deadlines.meanLateness;
+        deadlineJson["minLateness"] = deadlines.minLateness;
+        deadlineJson["p50Lateness"] = deadlines.p50Lateness;
+        deadlineJson["p90Lateness"] = deadlines.p90Lateness;
+        deadlineJson["p99Lateness"] = deadlines.p99Lateness;
+        deadlineJson["maxLateness"] = deadlines.maxLateness;
+        deadlineJson["maxTardiness"] = deadlines.maxTardiness;
+        result["deadlines"] = std::move(deadlineJson);
+    }
+
+    const ShareStats& shares = r.shares;
+    if (shares.jobs > 0) {
+        crow::json::wvalue shareJson;
+        shareJson["meanAbsShareError"] = shares.meanAbsShareError;
+        shareJson["maxAbsShareError"] = shares.maxAbsShareError;
+        shareJson["maxLag"] = shares.maxLag;
+        result["shares"] = std::move(shareJson);
+    }
+}
+
+// JSON of a CPU/I-O simulation result
+crow::json::wvalue ioResultJson(const AlgorithmResult& r) {
+    crow::json::wvalue result;
+    result["name"] = r.name;
+    addSummaryJson(result, r);
+    result["ioOverlap"] = r.io.overlap;
+    result["avgIoWaitTime"] = r.io.avgIoWaitTime;
+    crow::json::wvalue deviceUtilization = crow::json::wvalue::list();
+    for (size_t d = 0; d < r.io.deviceUtilization.size(); d++) {
+        deviceUtilization[d] = r.io.deviceUtilization[d];
+    }
+    result["deviceUtilization"] = std::move(deviceUtilization);
+
+    crow::json::wvalue ganttChart = crow::json::wvalue::list();
+    for (size_t j = 0; j < r.ganttChart.size(); j++) {
+        crow::json::wvalue entry;
+        entry["processId"] = r.ganttChart[j].processId;
+        entry["startTime"] = r.ganttChart[j].startTime;
+        entry["endTime"] = r.ganttChart[j].endTime;
+        ganttChart[j] = std::move(entry);
+    }
+    result["ganttChart"] = std::move(ganttChart);
+
+    crow::json::wvalue ioChart = crow::json::wvalue::list();
+    for (size_t j = 0; j < r.io.ioChart.size(); j++) {
+        crow::json::wvalue entry;
+        entry["processId"] = r.io.ioChart[j].processId;
+        entry["device"] = r.io.ioChart[j].cpu;
+        entry["startTime"] = r.io.ioChart[j].startTime;
+        entry["endTime"] = r.io.ioChart[j].endTime;
+        ioChart[j] = std::move(entry);
+    }
+    result["ioChart"] = std::move(ioChart);
+
+    crow::json::wvalue processMetrics = crow::json::wvalue::list();
+    for (size_t j = 0; j < r.processMetrics.size(); j++) {
+        const ProcessMetrics& pm = r.processMetrics[j];
+        crow::json::wvalue processResult;
+        processResult["id"] = pm.id;
+        processResult["arrivalTime"] = pm.arrivalTime;
+        processResult["cpuTime"] = pm.burstTime;
+        processResult["priority"] = pm.priority;
+        processResult["completionTime"] = pm.completionTime;
+        processResult["turnaroundTime"] = pm.turnaroundTime;
+        processResult["waitingTime"] = pm.waitingTime;
+        processResult["responseTime"] = pm.responseTime;
+        processResult["dispatches"] = pm.dispatches;
+        processResult["preemptions"] = pm.preemptions;
+        processMetrics[j] = std::move(processResult);
+    }
+    result["processes"] = std::move(processMetrics);
+    if (r.io.blocked > 0) {
+        result["blocked"] = r.io.blocked;
+    }
+    return result;
+}
+
+// Processes of a request body come either inline or from a stored workload.
+// Returns nullptr when the referenced workload is unknown, or with `error`
+// set when the inline processes are invalid.
+shared_ptr<const vector<Process>> loadWorkload(const crow::json::rvalue& params, WorkloadStore& store, string& error) {
+    if (params.has("workloadId")) {
+        return store.get(params["workloadId"].s());
+    }
+    vector<Process> processes;
+    error = parseProcesses(params["processes"], processes);
+    if (!error.empty()) {
+        return nullptr;
+    }
+    return make_shared<const vector<Process>>(std::move(processes));
+}
+
+// Integer query parameter; false when it is present but not an integer
+bool queryInt(const crow::request& req, const char* key, long long& value) {
+    const char* text = req.url_params.get(key);
+    if (!text) {
+        return true;
+    }
+    char* rest = nullptr;
+    long long parsed = strtoll(text, &rest, 10);
+    if (rest == text || *rest != '\0') {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Middleware for handling CORS
+struct CORSMiddleware {
+    struct context {};
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx) {
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type");
+        res.set_header("Access-Control-Expose-Headers", "X-Workload-Seed");
+    }
+
+    void after_handle(crow::request&, crow::response&, context&) {}
+};
+
+int main() {
+    // Create Crow app with CORS middleware
+    crow::App<CORSMiddleware> app;
+
+    // Workload store limits: WORKLOAD_STORE_MAX_BYTES caps memory use,
+    // WORKLOAD_STORE_DIR (optional) persists uploaded workloads to disk
+    size_t workloadStoreBytes = 256u << 20;
+    if (const char* env = getenv("WORKLOAD_STORE_MAX_BYTES")) {
+        workloadStoreBytes = strtoull(env, nullptr, 10);
+    }
+    const char* workloadDir = getenv("WORKLOAD_STORE_DIR");
+    WorkloadStore workloadStore(workloadStoreBytes, workloadDir ? workloadDir : "");
+
+    // Results kept for Gantt queries ("storeResults"), capped by RESULT_STORE_MAX_BYTES
+    size_t resultStoreBytes = 1024u << 20;
+    if (const char* env = getenv("RESULT_STORE_MAX_BYTES")) {
+        resultStoreBytes = strtoull(env, nullptr, 10);
+    }
+    ResultStore resultStore(resultStoreBytes);
+
+    // Generate processes; ?seed= makes the workload reproducible, and the
+    // seed used comes back in the X-Workload-Seed header either way
+    CROW_ROUTE(app, "/api/processes/<int>")
+    ([](const crow::request& req, int count) {
+        random_device rd;
+        uint64_t seed = static_cast<uint64_t>(rd()) << 32 | rd();
+        if (const char* text = req.url_params.get("seed")) {
+            char* rest = nullptr;
+            seed = strtoull(text, &rest, 10);
+            if (rest == text || *rest != '\0') {
+                return crow::response(400, "seed must be an unsigned integer");
+            }
+        }
+        auto processes = generateRandomProcesses(count, seed);
+
+        crow::json::wvalue response = crow::json::wvalue::list();
+        for (size_t i = 0; i < processes.size(); i++) {
+            crow::json::wvalue process;
+            process["id"] = processes[i].id;
+            process["burstTime"] = processes[i].burstTime;
+            process["arrivalTime"] = processes[i].arrivalTime;
+            process["priority"] = processes[i].priority;
+            response[i] = std::move(process);
+        }
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        res.set_header("X-Workload-Seed", to_string(seed));
+        return res;
+    });
+
+    // Upload a workload once and reference it by ID in later requests
+    CROW_ROUTE(app, "/api/workloads").methods("POST"_method)
+    ([&workloadStore](const crow::request& req) {
+        auto params = crow::json::load(req.body);
+
+        if (!params) {
+            return crow::response(400, "Invalid JSON");
+        }
+
+        vector<Process> processes;
+        string error = parseProcesses(params["processes"], processes);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+        size_t count = processes.size();
+        size_t bytes = WorkloadStore::workloadBytes(processes);
+
+        bool persisted = false;
+        crow::json::wvalue response;
+        response["id"] = workloadStore.put(std::move(processes), persisted);
+        response["processCount"] = count;
+        response["bytes"] = bytes;
+        response["persisted"] = persisted;
+
+        crow::response res(201, response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    CROW_ROUTE(app, "/api/workloads/<string>").methods("GET"_method)
+    ([&workloadStore](const string& id) {
+        auto workload = workloadStore.get(id);
+        if (!workload) {
+            return crow::response(404, "Unknown workload");
+        }
+
+        crow::json::wvalue response;
+        response["id"] = id;
+        response["processCount"] = workload->size();
+        response["bytes"] = WorkloadStore::workloadBytes(*workload);
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    CROW_ROUTE(app, "/api/workloads/<string>").methods("DELETE"_method)
+    ([&workloadStore](const string& id) {
+        if (!workloadStore.remove(id)) {
+            return crow::response(404, "Unknown workload");
+        }
+        return crow::response(204);
+    });
+
+    // Run algorithms on processes
+    CROW_ROUTE(app, "/api/schedule").methods("POST"_method)
+    ([&workloadStore, &resultStore](const crow::request& req) {
+        auto params = crow::json::load(req.body);
+
+        if (!params) {
+            return crow::response(400, "Invalid JSON");
+        }
+
+        string error;
+        auto workload = loadWorkload(params, workloadStore, error);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+        if (!workload) {
+            return crow::response(404, "Unknown workload");
+        }
+        const vector<Process>& processes = *workload;
+
+        AlgorithmParams algorithmParams;
+        error = parseAlgorithmParams(params, algorithmParams);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+
+        SimOptions simOptions;
+        error = parseSimOptions(params, simOptions);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+
+        // Engines skip the Gantt chart and per-process rows when the
+        // response leaves those sections out
+        ResponseShape shape;
+        error = parseResponseShape(params, shape);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+        simOptions.recordGantt = simOptions.recordGantt && shape.gantt;
+        simOptions.recordProcesses = simOptions.recordProcesses && shape.processes;
+
+        // Stored results keep both server-side even when the response
+        // leaves them out
+        bool storeResults = params.has("storeResults") && params["storeResults"].b();
+        bool emitGantt = simOptions.recordGantt;
+        bool emitProcesses = simOptions.recordProcesses;
+        if (storeResults) {
+            simOptions.recordGantt = true;
+            simOptions.recordProcesses = true;
+        }
+
+        vector<const AlgorithmEntry*> algorithms;
+        for (const auto& algorithm : algorithmRegistry()) {
+            if (params["algorithms"].has(algorithm.key) && params["algorithms"][algorithm.key].b()) {
+                error = checkAlgorithmParams(algorithm, algorithmParams);
+                if (!error.empty()) {
+                    return crow::response(400, error);
+                }
+                algorithms.push_back(&algorithm);
+            }
+        }
+
+        vector<AlgorithmResult> results;
+
+        // Optionally simulate independent busy periods in parallel
+        bool parallelBusyPeriods = params.has("parallelBusyPeriods") && params["parallelBusyPeriods"].b() &&
+                                   !usesSmpCore(algorithmParams);
+
+        // Run each selected algorithm on a fresh copy of the processes
+        for (const AlgorithmEntry* algorithm : algorithms) {
+            if (parallelBusyPeriods && algorithm->splitsAtIdle) {
+                results.push_back(runByBusyPeriods(processes, *algorithm, algorithmParams, simOptions));
+            } else {
+                results.push_back(algorithm->run(processes, algorithmParams, simOptions));
+            }
+        }
+
+        // Create response JSON
+        crow::json::wvalue response = crow::json::wvalue::list();
+        for (size_t i = 0; i < results.size(); i++) {
+            crow::json::wvalue result;
+            result["name"] = results[i].name;
+            if (shape.summary) {
+                addSummaryJson(result, results[i]);
+            }
+
+            // Add gantt chart data
+            if (shape.gantt) {
+                result["ganttChart"] = emitGantt ? ganttJson(results[i].ganttChart) : crow::json::wvalue::list();
+            }
+
+            // Add process-specific metrics, one page of them when paginated
+            const vector<ProcessMetrics>& rows = results[i].processMetrics;
+            size_t processCount = emitProcesses ? rows.size() : 0;
+            if (shape.processes) {
+                size_t from = std::min(shape.processCursor, processCount);
+                size_t to = from + std::min(shape.processLimit, processCount - from);
+                crow::json::wvalue processMetrics = crow::json::wvalue::list();
+                for (size_t j = from; j < to; j++) {
+                    processMetrics[j - from] = processJson(rows[j], shape.processFields);
+                }
+                result["processes"] = std::move(processMetrics);
+                result["processCount"] = processCount;
+                if (to < processCount) {
+                    result["nextProcessCursor"] = to;
+                }
+            }
+
+            if (storeResults) {
+                auto stored = make_shared<const StoredResult>(StoredResult{
+                    results[i].name, results[i].makespan,
+                    GanttIndex(std::move(results[i].ganttChart), results[i].makespan),
+                    std::move(results[i].processMetrics)});
+                result["resultId"] = resultStore.put(std::move(stored));
+            }
+
+            response[i] = std::move(result);
+        }
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
 
-    for (auto& p : processes) {
-        remainingProcesses.push_back(&p);
-        p.started = false;
-    }
+    // Stored results (see "storeResults" above)
+    CROW_ROUTE(app, "/api/results/<string>").methods("GET"_method)
+    ([&resultStore](const string& id) {
+        auto stored = resultStore.get(id);
+        if (!stored) {
+            return crow::response(404, "Unknown result");
+        }
 
-    std::sort(remainingProcesses.begin(), remainingProcesses.end(), [](const Process* a, const Process* b) {
-        return a->arrivalTime < b->arrivalTime;
+        crow::json::wvalue response;
+        response["id"] = id;
+        response["name"] = stored->name;
+        response["makespan"] = stored->makespan;
+        response["cpus"] = stored->gantt.cpus();
+        response["segments"] = stored->gantt.segmentCount();
+        response["processes"] = stored->processes.size();
+        response["bytes"] = ResultStore::resultBytes(*stored);
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
     });
 
-    std::vector<std::pair<Process*, int>> remainingBurstTimes;
-    for (auto* p : remainingProcesses) {
-        remainingBurstTimes.push_back({p, p->burstTime});
-    }
+    CROW_ROUTE(app, "/api/results/<string>").methods("DELETE"_method)
+    ([&resultStore](const string& id) {
+        if (!resultStore.remove(id)) {
+            return crow::response(404, "Unknown result");
+        }
+        return crow::response(204);
+    });
 
-    int currentTime = 0;
-    Process* currentProcess = nullptr;
+    // Level-of-detail Gantt view: ?start=&end=&buckets= splits the window
+    // (default the whole run, 500 buckets) into buckets with the process that
+    // ran most in each, and the shares of busy, overhead and idle CPU time
+    CROW_ROUTE(app, "/api/results/<string>/gantt").methods("GET"_method)
+    ([&resultStore](const crow::request& req, const string& id) {
+        auto stored = resultStore.get(id);
+        if (!stored) {
+            return crow::response(404, "Unknown result");
+        }
 
-    while (!remainingBurstTimes.empty()) {
-        // Update available processes at current time
-        std::vector<std::pair<Process*, int>> availableProcesses;
-        for (const auto& pair : remainingBurstTimes) {
-            if (pair.first->arrivalTime <= currentTime) {
-                availableProcesses.push_back(pair);
-            }
+        long long start = 0;
+        long long end = stored->makespan;
+        long long buckets = 500;
+        if (!queryInt(req, "start", start) || !queryInt(req, "end", end) || !queryInt(req, "buckets", buckets)) {
+            return crow::response(400, "start, end and buckets must be integers");
+        }
+        if (buckets < 1 || buckets > maxLodBuckets) {
+            return crow::response(400, "buckets must be between 1 and " + to_string(maxLodBuckets));
         }
+        start = std::max(start, 0LL);
+        end = std::min<long long>(end, stored->makespan);
+        if (start >= end) {
+            return crow::response(400, "Empty time window");
+        }
+        // No bucket narrower than one time unit
+        buckets = std::min(buckets, end - start);
 
-        if (availableProcesses.empty()) {
-            // Fast-forward to the next process arrival
-            int nextArrival = INT_MAX;
-            for (const auto& pair : remainingBurstTimes) {
-                if (pair.first->arrivalTime < nextArrival) {
-                    nextArrival = pair.first->arrivalTime;
-                }
-            }
-            currentTime = nextArrival;
-            continue;
+        GanttIndex::View view = stored->gantt.aggregate(start, end, static_cast<int>(buckets));
+        int cpus = stored->gantt.cpus();
+
+        crow::json::wvalue response;
+        response["start"] = start;
+        response["end"] = end;
+        response["exact"] = view.exact;
+        if (!view.exact) {
+            response["cellWidth"] = view.cellWidth;
         }
+        crow::json::wvalue bounds = crow::json::wvalue::list();
+        crow::json::wvalue dominant = crow::json::wvalue::list();
+        crow::json::wvalue dominantShare = crow::json::wvalue::list();
+        crow::json::wvalue occupancy = crow::json::wvalue::list();
+        crow::json::wvalue overhead = crow::json::wvalue::list();
+        crow::json::wvalue idle = crow::json::wvalue::list();
+        for (size_t b = 0; b < view.buckets.size(); b++) {
+            const GanttIndex::Bucket& bucket = view.buckets[b];
+            double capacity = static_cast<double>(bucket.end - bucket.start) * cpus;
+            bounds[b] = bucket.start;
+            dominant[b] = bucket.dominantProcess;
+            dominantShare[b] = bucket.dominantTime / capacity;
+            occupancy[b] = bucket.busy / capacity;
+            overhead[b] = bucket.overhead / capacity;
+            idle[b] = std::max(0.0, 1 - (bucket.busy + bucket.overhead) / capacity);
+        }
+        bounds[view.buckets.size()] = end;
+        response["bounds"] = std::move(bounds);
+        response["dominantProcess"] = std::move(dominant);
+        response["dominantShare"] = std::move(dominantShare);
+        response["occupancy"] = std::move(occupancy);
+        response["overhead"] = std::move(overhead);
+        response["idle"] = std::move(idle);
 
-        // Find the process with highest priority
-        auto it = std::min_element(availableProcesses.begin(), availableProcesses.end(),
-                                   [](const auto& a, const auto& b) {
-                                       return a.first->priority < b.first->priority;
-                                   });
-        Process* selectedProcess = it->first;
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
 
-        // Create a new gantt entry or extend the last one if it's the same process
-        if (!ganttChart.empty() && ganttChart.back().processId == selectedProcess->id) {
-            ganttChart.back().endTime = currentTime + 1;
-        } else {
-            if (!ganttChart.empty()) {
-                ganttChart.back().endTime = currentTime;
-            }
-            GanttEntry entry;
-            entry.processId = selectedProcess->id;
-            entry.startTime = currentTime;
-            entry.endTime = currentTime + 1;
-            ganttChart.push_back(entry);
+    // Per-process rows of a stored result, paged by ?cursor= and ?limit= and
+    // projected by ?fields= (comma-separated names, default all)
+    CROW_ROUTE(app, "/api/results/<string>/processes").methods("GET"_method)
+    ([&resultStore](const crow::request& req, const string& id) {
+        auto stored = resultStore.get(id);
+        if (!stored) {
+            return crow::response(404, "Unknown result");
+        }
 
-            if (!selectedProcess->started) {
-                selectedProcess->responseTime = currentTime - selectedProcess->arrivalTime;
-                selectedProcess->started = true;
+        long long cursor = 0;
+        long long limit = 1000;
+        if (!queryInt(req, "cursor", cursor) || !queryInt(req, "limit", limit)) {
+            return crow::response(400, "cursor and limit must be integers");
+        }
+        if (limit < 1 || limit > maxPageLimit) {
+            return crow::response(400, "limit must be between 1 and " + to_string(maxPageLimit));
+        }
+        if (cursor < 0) {
+            return crow::response(400, "cursor must not be negative");
+        }
+        uint32_t fields = allProcessFields;
+        if (const char* list = req.url_params.get("fields")) {
+            vector<string> names;
+            stringstream stream(list);
+            for (string name; getline(stream, name, ',');) {
+                names.push_back(name);
+            }
+            string unknown = processFieldMask(names, fields);
+            if (!unknown.empty()) {
+                return crow::response(400, "Unknown process field: " + unknown);
             }
         }
 
-        // Update the remaining burst time
-        for (auto& pair : remainingBurstTimes) {
-            if (pair.first == selectedProcess) {
-                pair.second--;
-                if (pair.second == 0) {
-                    // Process completed
-                    selectedProcess->completionTime = currentTime + 1;
-                    selectedProcess->turnaroundTime = selectedProcess->completionTime - selectedProcess->arrivalTime;
-                    selectedProcess->waitingTime = selectedProcess->turnaroundTime - selectedProcess->burstTime;
+        const vector<ProcessMetrics>& rows = stored->processes;
+        size_t from = std::min<size_t>(cursor, rows.size());
+        size_t to = std::min<size_t>(from + limit, rows.size());
+        crow::json::wvalue page = crow::json::wvalue::list();
+        for (size_t j = from; j < to; j++) {
+            page[j - from] = processJson(rows[j], fields);
+        }
 
-                    // Remove the completed process
-                    remainingBurstTimes.erase(std::remove(remainingBurstTimes.begin(), remainingBurstTimes.end(), pair),
-                                              remainingBurstTimes.end());
-                    break;
-                }
-            }
+        crow::json::wvalue response;
+        response["total"] = rows.size();
+        response["processes"] = std::move(page);
+        if (to < rows.size()) {
+            response["nextCursor"] = to;
         }
 
-        currentTime++;
-    }
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
 
-    // Clean up gantt chart by merging consecutive entries with same process
-    std::vector<GanttEntry> mergedGanttChart;
-    for (const auto& entry : ganttChart) {
-        if (mergedGanttChart.empty() || mergedGanttChart.back().processId != entry.processId) {
-            mergedGanttChart.push_back(entry);
-        } else {
-            mergedGanttChart.back().endTime = entry.endTime;
+    // The whole stored chart in the CompactGantt download format
+    CROW_ROUTE(app, "/api/results/<string>/gantt/compact").methods("GET"_method)
+    ([&resultStore](const string& id) {
+        auto stored = resultStore.get(id);
+        if (!stored) {
+            return crow::response(404, "Unknown result");
         }
-    }
 
-    return calculateMetrics("Priority (Preemptive)", processes, mergedGanttChart);
-}
+        crow::response res(stored->gantt.compact().wireFormat());
+        res.set_header("Content-Type", "application/octet-stream");
+        return res;
+    });
 
-// Middleware for handling CORS
-struct CORSMiddleware {
-    struct context {};
+    // Segments overlapping a window: ?start=&end= (default the whole run),
+    // paged by ?cursor= and ?limit=; "nextCursor" is absent on the last page
+    CROW_ROUTE(app, "/api/results/<string>/segments").methods("GET"_method)
+    ([&resultStore](const crow::request& req, const string& id) {
+        auto stored = resultStore.get(id);
+        if (!stored) {
+            return crow::response(404, "Unknown result");
+        }
 
-    void before_handle(crow::request& req, crow::response& res, context& ctx) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type");
-    }
+        long long start = 0;
+        long long end = stored->makespan;
+        long long cursor = 0;
+        long long limit = 1000;
+        if (!queryInt(req, "start", start) || !queryInt(req, "end", end) || !queryInt(req, "cursor", cursor) ||
+            !queryInt(req, "limit", limit)) {
+            return crow::response(400, "start, end, cursor and limit must be integers");
+        }
+        if (limit < 1 || limit > maxPageLimit) {
+            return crow::response(400, "limit must be between 1 and " + to_string(maxPageLimit));
+        }
+        if (cursor < 0) {
+            return crow::response(400, "cursor must not be negative");
+        }
 
-    void after_handle(crow::request&, crow::response&, context&) {}
-};
+        vector<GanttEntry> page;
+        size_t next = stored->gantt.segmentsIn(start, end, cursor, limit, page);
 
-int main() {
-    // Create Crow app with CORS middleware
-    crow::App<CORSMiddleware> app;
+        crow::json::wvalue response;
+        response["segments"] = ganttJson(page);
+        if (next < stored->gantt.segmentCount()) {
+            response["nextCursor"] = next;
+        }
 
-    // Generate processes
-    CROW_ROUTE(app, "/api/processes/<int>")
-    ([](int count) {
-        auto processes = generateRandomProcesses(count);
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
 
-        crow::json::wvalue response = crow::json::wvalue::list();
-        for (size_t i = 0; i < processes.size(); i++) {
-            crow::json::wvalue process;
-            process["id"] = processes[i].id;
-            process["burstTime"] = processes[i].burstTime;
-            process["arrivalTime"] = processes[i].arrivalTime;
-            process["priority"] = processes[i].priority;
-            response[i] = std::move(process);
+    // Segments of one process in time order, paged like the route above
+    CROW_ROUTE(app, "/api/results/<string>/processes/<int>/segments").methods("GET"_method)
+    ([&resultStore](const crow::request& req, const string& id, int processId) {
+        auto stored = resultStore.get(id);
+        if (!stored) {
+            return crow::response(404, "Unknown result");
+        }
+
+        long long cursor = 0;
+        long long limit = 1000;
+        if (!queryInt(req, "cursor", cursor) || !queryInt(req, "limit", limit)) {
+            return crow::response(400, "cursor and limit must be integers");
+        }
+        if (limit < 1 || limit > maxPageLimit) {
+            return crow::response(400, "limit must be between 1 and " + to_string(maxPageLimit));
+        }
+        if (cursor < 0) {
+            return crow::response(400, "cursor must not be negative");
+        }
+
+        size_t total = stored->gantt.processSegmentCount(processId);
+        vector<GanttEntry> page;
+        size_t next = stored->gantt.processSegmentsFrom(processId, cursor, limit, page);
+
+        crow::json::wvalue response;
+        response["processId"] = processId;
+        response["total"] = total;
+        response["segments"] = ganttJson(page);
+        if (next < total) {
+            response["nextCursor"] = next;
         }
 
         crow::response res(response);
@@ -602,8 +5586,8 @@ int main() {
         return res;
     });
 
-    // Run algorithms on processes
-    CROW_ROUTE(app, "/api/schedule").methods("POST"_method)
+    // Simulate CPU/I-O burst sequences with FCFS device queues
+    CROW_ROUTE(app, "/api/schedule/io").methods("POST"_method)
     ([](const crow::request& req) {
         auto params = crow::json::load(req.body);
 
@@ -611,89 +5595,387 @@ int main() {
             return crow::response(400, "Invalid JSON");
         }
 
+        int deviceCount = params.has("devices") ? static_cast<int>(params["devices"].i()) : 1;
+        if (deviceCount < 1 || deviceCount > 1024) {
+            return crow::response(400, "devices must be between 1 and 1024");
+        }
+        AlgorithmParams algorithmParams;
+        string error = parseAlgorithmParams(params, algorithmParams);
+        if (error.empty()) {
+            error = checkIoEngineParams(params, algorithmParams);
+        }
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
         vector<Process> processes;
-        for (const auto& item : params["processes"]) {
-            Process p;
-            p.id = item["id"].i();
-            p.burstTime = item["burstTime"].i();
-            p.arrivalTime = item["arrivalTime"].i();
-            p.priority = item["priority"].i();
-            processes.push_back(p);
+        BurstTrace trace;
+        error = parseBurstWorkload(params["processes"], deviceCount, processes, trace);
+        if (!error.empty()) {
+            return crow::response(400, error);
         }
-
-        int timeQuantum = 2;
-        if (params.has("timeQuantum")) {
-            timeQuantum = params["timeQuantum"].i();
+        SimOptions options;
+        error = parseSimOptions(params, options);
+        if (!error.empty()) {
+            return crow::response(400, error);
         }
 
         vector<AlgorithmResult> results;
+        for (const auto& [key, policy] : ioPolicies()) {
+            if (params["algorithms"].has(key) && params["algorithms"][key].b()) {
+                TraceBursts source(trace);
+                results.push_back(ioSchedule(processes, source, policy, algorithmParams.timeQuantum, deviceCount,
+                                             options));
+            }
+        }
 
-        // Run each selected algorithm on a fresh copy of the processes
-        if (params["algorithms"].has("fcfs") && params["algorithms"]["fcfs"].b()) {
-            vector<Process> processesCopy = processes;
-            results.push_back(fcfs(processesCopy));
+        crow::json::wvalue response = crow::json::wvalue::list();
+        for (size_t i = 0; i < results.size(); i++) {
+            response[i] = ioResultJson(results[i]);
+        }
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    // Simulate processes whose behaviour is a coroutine model, under the CPU/I-O engine
+    CROW_ROUTE(app, "/api/schedule/models").methods("POST"_method)
+    ([](const crow::request& req) {
+        auto params = crow::json::load(req.body);
+
+        if (!params) {
+            return crow::response(400, "Invalid JSON");
         }
-        if (params["algorithms"].has("sjf") && params["algorithms"]["sjf"].b()) {
-            vector<Process> processesCopy = processes;
-            results.push_back(sjf(processesCopy));
+
+        int deviceCount = params.has("devices") ? static_cast<int>(params["devices"].i()) : 1;
+        if (deviceCount < 1 || deviceCount > 1024) {
+            return crow::response(400, "devices must be between 1 and 1024");
         }
-        if (params["algorithms"].has("srtn") && params["algorithms"]["srtn"].b()) {
-            vector<Process> processesCopy = processes;
-            results.push_back(srtn(processesCopy));
+        AlgorithmParams algorithmParams;
+        string error = parseAlgorithmParams(params, algorithmParams);
+        if (error.empty()) {
+            error = checkIoEngineParams(params, algorithmParams);
         }
-        if (params["algorithms"].has("roundRobin") && params["algorithms"]["roundRobin"].b()) {
-            vector<Process> processesCopy = processes;
-            results.push_back(roundRobin(processesCopy, timeQuantum));
+        if (!error.empty()) {
+            return crow::response(400, error);
         }
-        if (params["algorithms"].has("priority") && params["algorithms"]["priority"].b()) {
-            vector<Process> processesCopy = processes;
-            results.push_back(priorityNonPreemptive(processesCopy));
+        ModelWorkload workload;
+        error = parseModelWorkload(params, deviceCount, workload);
+        if (!error.empty()) {
+            return crow::response(400, error);
         }
-        if (params["algorithms"].has("priorityPreemptive") && params["algorithms"]["priorityPreemptive"].b()) {
-            vector<Process> processesCopy = processes;
-            results.push_back(priorityPreemptive(processesCopy));
+        SimOptions options;
+        error = parseSimOptions(params, options);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+
+        vector<AlgorithmResult> results;
+        for (const auto& [key, policy] : ioPolicies()) {
+            if (params["algorithms"].has(key) && params["algorithms"][key].b()) {
+                CoroutineBursts source(workload.spawn(), workload.eventCount);
+                results.push_back(ioSchedule(workload.processes, source, policy, algorithmParams.timeQuantum,
+                                             deviceCount, options));
+            }
         }
 
-        // Create response JSON
         crow::json::wvalue response = crow::json::wvalue::list();
         for (size_t i = 0; i < results.size(); i++) {
-            crow::json::wvalue result;
-            result["name"] = results[i].name;
-            result["avgTurnaroundTime"] = results[i].avgTurnaroundTime;
-            result["avgWaitingTime"] = results[i].avgWaitingTime;
-            result["avgResponseTime"] = results[i].avgResponseTime;
-            result["avgCompletionTime"] = results[i].avgCompletionTime;
-            result["throughput"] = results[i].throughput;
+            response[i] = ioResultJson(results[i]);
+        }
 
-            // Add gantt chart data
-            crow::json::wvalue ganttChart = crow::json::wvalue::list();
-            for (size_t j = 0; j < results[i].ganttChart.size(); j++) {
-                crow::json::wvalue entry;
-                entry["processId"] = results[i].ganttChart[j].processId;
-                entry["startTime"] = results[i].ganttChart[j].startTime;
-                entry["endTime"] = results[i].ganttChart[j].endTime;
-                ganttChart[j] = std::move(entry);
-            }
-            result["ganttChart"] = std::move(ganttChart);
-
-            // Add process-specific metrics
-            crow::json::wvalue processMetrics = crow::json::wvalue::list();
-            for (const auto& pm : results[i].processMetrics) {
-                crow::json::wvalue processResult;
-                processResult["id"] = pm.id;
-                processResult["arrivalTime"] = pm.arrivalTime;
-                processResult ["burstTime"] = pm.burstTime;
-                 processResult ["priority"] = pm.priority;
-                processResult["completionTime"] = pm.completionTime;
-                processResult["turnaroundTime"] = pm.turnaroundTime;
-                processResult["waitingTime"] = pm.waitingTime;
-                processResult["responseTime"] = pm.responseTime;
-                processMetrics[processMetrics.size()] = std::move(processResult);
-            }
-            result["processes"] = std::move(processMetrics);
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
 
-            response[i] = std::move(result);
+    // Evaluate Round Robin over many time quanta on one shared workload
+    CROW_ROUTE(app, "/api/schedule/sweep").methods("POST"_method)
+    ([&workloadStore](const crow::request& req) {
+        auto params = crow::json::load(req.body);
+
+        if (!params) {
+            return crow::response(400, "Invalid JSON");
+        }
+
+        string workloadError;
+        auto workload = loadWorkload(params, workloadStore, workloadError);
+        if (!workloadError.empty()) {
+            return crow::response(400, workloadError);
+        }
+        if (!workload) {
+            return crow::response(404, "Unknown workload");
+        }
+
+        // Quanta are given either as an explicit list or as {from, to, step}
+        vector<int> quanta;
+        if (params.has("quanta")) {
+            for (const auto& q : params["quanta"]) {
+                quanta.push_back(q.i());
+            }
+        } else if (params.has("quantumRange")) {
+            const auto& range = params["quantumRange"];
+            int from = range["from"].i();
+            int to = range["to"].i();
+            int step = range.has("step") ? range["step"].i() : 1;
+            if (from < 1) {
+                return crow::response(400, "Time quanta must be at least 1");
+            }
+            if (step < 1 || to < from) {
+                return crow::response(400, "Invalid quantumRange");
+            }
+            // Count in 64 bits so ranges near INT_MAX cannot wrap
+            long long count = (static_cast<long long>(to) - from) / step + 1;
+            if (count > maxSweepPoints) {
+                return crow::response(400, "Expected between 1 and " + to_string(maxSweepPoints) + " quanta");
+            }
+            for (long long i = 0; i < count; i++) {
+                quanta.push_back(static_cast<int>(from + i * step));
+            }
+        }
+        if (quanta.empty() || quanta.size() > static_cast<size_t>(maxSweepPoints)) {
+            return crow::response(400, "Expected between 1 and " + to_string(maxSweepPoints) + " quanta");
+        }
+        if (*min_element(quanta.begin(), quanta.end()) < 1) {
+            return crow::response(400, "Time quanta must be at least 1");
+        }
+        SwitchCost switchCost;
+        string error = parseSwitchCost(params, switchCost);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+
+        SimOptions options;
+        options.recordGantt = false;
+        options.recordProcesses = false;
+
+        vector<AlgorithmResult> results(quanta.size());
+        parallelFor(quanta.size(), [&](size_t i) {
+            results[i] = roundRobinAt(*workload, quanta[i], switchCost, options);
+        });
+
+        crow::json::wvalue response;
+        crow::json::wvalue quantaJson = crow::json::wvalue::list();
+        crow::json::wvalue avgWaitingTime = crow::json::wvalue::list();
+        crow::json::wvalue avgResponseTime = crow::json::wvalue::list();
+        crow::json::wvalue avgTurnaroundTime = crow::json::wvalue::list();
+        crow::json::wvalue contextSwitches = crow::json::wvalue::list();
+        crow::json::wvalue overheadTime = crow::json::wvalue::list();
+        crow::json::wvalue cpuUtilization = crow::json::wvalue::list();
+        for (size_t i = 0; i < results.size(); i++) {
+            quantaJson[i] = quanta[i];
+            avgWaitingTime[i] = results[i].avgWaitingTime;
+            avgResponseTime[i] = results[i].avgResponseTime;
+            avgTurnaroundTime[i] = results[i].avgTurnaroundTime;
+            contextSwitches[i] = results[i].contextSwitches;
+            overheadTime[i] = results[i].overheadTime;
+            cpuUtilization[i] = results[i].cpuUtilization;
+        }
+        response["quanta"] = std::move(quantaJson);
+        response["avgWaitingTime"] = std::move(avgWaitingTime);
+        response["avgResponseTime"] = std::move(avgResponseTime);
+        response["avgTurnaroundTime"] = std::move(avgTurnaroundTime);
+        response["contextSwitches"] = std::move(contextSwitches);
+        response["overheadTime"] = std::move(overheadTime);
+        response["cpuUtilization"] = std::move(cpuUtilization);
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    // Search for the time quantum that minimizes an objective over RR metrics
+    CROW_ROUTE(app, "/api/schedule/tune").methods("POST"_method)
+    ([&workloadStore](const crow::request& req) {
+        auto params = crow::json::load(req.body);
+
+        if (!params) {
+            return crow::response(400, "Invalid JSON");
+        }
+
+        string workloadError;
+        auto workload = loadWorkload(params, workloadStore, workloadError);
+        if (!workloadError.empty()) {
+            return crow::response(400, workloadError);
+        }
+        if (!workload) {
+            return crow::response(404, "Unknown workload");
+        }
+
+        // "objective" is a metric name or {"weights": {metric: weight, ...}}
+        TuningObjective objective;
+        auto setWeight = [&objective](const string& metric, double weight) {
+            if (metric == "avgWaitingTime") objective.avgWaitingTime = weight;
+            else if (metric == "avgResponseTime") objective.avgResponseTime = weight;
+            else if (metric == "avgTurnaroundTime") objective.avgTurnaroundTime = weight;
+            else if (metric == "p99ResponseTime") objective.p99ResponseTime = weight;
+            else if (metric == "contextSwitches") objective.contextSwitches = weight;
+            else return false;
+            return true;
+        };
+        if (!params.has("objective")) {
+            objective.avgWaitingTime = 1;
+        } else if (params["objective"].t() == crow::json::type::String) {
+            if (!setWeight(params["objective"].s(), 1)) {
+                return crow::response(400, "Unknown objective");
+            }
+        } else {
+            const auto& weights = params["objective"]["weights"];
+            for (const auto& metric : weights.keys()) {
+                if (!setWeight(metric, weights[metric].d())) {
+                    return crow::response(400, "Unknown objective metric: " + metric);
+                }
+            }
+        }
+
+        int maxBurst = 1;
+        for (const auto& p : *workload) {
+            maxBurst = max(maxBurst, p.burstTime);
+        }
+        int minQuantum = params.has("minQuantum") ? params["minQuantum"].i() : 1;
+        int maxQuantum = params.has("maxQuantum") ? params["maxQuantum"].i() : maxBurst;
+        double tolerance = params.has("tolerance") ? params["tolerance"].d() : 0.001;
+        int maxEvaluations = params.has("maxEvaluations") ? params["maxEvaluations"].i() : 200;
+        if (minQuantum < 1 || maxQuantum < minQuantum || maxEvaluations < 1) {
+            return crow::response(400, "Invalid quantum bounds");
+        }
+        SwitchCost switchCost;
+        string error = parseSwitchCost(params, switchCost);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+
+        QuantumTuning tuning = tuneQuantum(*workload, objective, minQuantum, maxQuantum, tolerance, maxEvaluations,
+                                           switchCost);
+
+        crow::json::wvalue response;
+        response["bestQuantum"] = tuning.bestQuantum;
+        response["objective"] = tuning.bestObjective;
+        response["avgWaitingTime"] = tuning.bestResult.avgWaitingTime;
+        response["avgResponseTime"] = tuning.bestResult.avgResponseTime;
+        response["avgTurnaroundTime"] = tuning.bestResult.avgTurnaroundTime;
+        response["p99ResponseTime"] = tuning.bestResult.responsePercentiles.p99;
+        response["contextSwitches"] = tuning.bestResult.contextSwitches;
+        response["overheadTime"] = tuning.bestResult.overheadTime;
+        response["cpuUtilization"] = tuning.bestResult.cpuUtilization;
+
+        crow::json::wvalue evaluations = crow::json::wvalue::list();
+        size_t i = 0;
+        for (const auto& [quantum, value] : tuning.evaluated) {
+            crow::json::wvalue evaluation;
+            evaluation["quantum"] = quantum;
+            evaluation["objective"] = value;
+            evaluations[i++] = std::move(evaluation);
+        }
+        response["evaluations"] = std::move(evaluations);
+
+        crow::response res(response);
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+
+    // Evaluate many workloads x algorithms in one call, aggregates only
+    CROW_ROUTE(app, "/api/schedule/batch").methods("POST"_method)
+    ([&workloadStore](const crow::request& req) {
+        auto params = crow::json::load(req.body);
+
+        if (!params) {
+            return crow::response(400, "Invalid JSON");
+        }
+
+        // Each workload is {"processes": [...]} or {"workloadId": "..."}
+        vector<shared_ptr<const vector<Process>>> workloads;
+        for (const auto& item : params["workloads"]) {
+            string workloadError;
+            auto workload = loadWorkload(item, workloadStore, workloadError);
+            if (!workloadError.empty()) {
+                return crow::response(400, "Workload at index " + to_string(workloads.size()) + ": " + workloadError);
+            }
+            if (!workload) {
+                return crow::response(404, "Unknown workload at index " + to_string(workloads.size()));
+            }
+            workloads.push_back(std::move(workload));
+        }
+
+        vector<const AlgorithmEntry*> algorithms;
+        for (const auto& algorithm : algorithmRegistry()) {
+            if (params["algorithms"].has(algorithm.key) && params["algorithms"][algorithm.key].b()) {
+                algorithms.push_back(&algorithm);
+            }
+        }
+
+        AlgorithmParams algorithmParams;
+        string error = parseAlgorithmParams(params, algorithmParams);
+        if (!error.empty()) {
+            return crow::response(400, error);
+        }
+        for (const AlgorithmEntry* algorithm : algorithms) {
+            error = checkAlgorithmParams(*algorithm, algorithmParams);
+            if (!error.empty()) {
+                return crow::response(400, error);
+            }
+        }
+
+        SimOptions options;
+        options.recordGantt = false;
+        options.recordProcesses = false;
+
+        auto cellJson = [&](size_t cell, const AlgorithmResult& result) {
+            crow::json::wvalue json;
+            json["workload"] = cell / algorithms.size();
+            json["algorithm"] = algorithms[cell % algorithms.size()]->key;
+            json["name"] = result.name;
+            addSummaryJson(json, result);
+            return json;
+        };
+
+        // Cells are laid out workload-major: cell = workload * algorithms + algorithm
+        size_t cellCount = workloads.size() * algorithms.size();
+        vector<AlgorithmResult> results(cellCount);
+
+        // A task is either one cell, or the FCFS column of a group of
+        // workloads that goes through the vectorized kernel together
+        struct BatchTask {
+            size_t algorithm;
+            size_t firstWorkload;
+            size_t workloadCount;
+            bool vectorized;
+        };
+        const size_t fcfsGroup = fcfsLanes * 8;
+        vector<BatchTask> tasks;
+        for (size_t a = 0; a < algorithms.size(); a++) {
+            bool vectorized = string(algorithms[a]->key) == "fcfs" && !usesSmpCore(algorithmParams) &&
+                              options.timelineBucket == 0;
+            size_t step = vectorized ? fcfsGroup : 1;
+            for (size_t w = 0; w < workloads.size(); w += step) {
+                tasks.push_back({a, w, std::min(step, workloads.size() - w), vectorized});
+            }
+        }
+
+        WorkStealingPool pool;
+        pool.run(tasks.size(), [&](size_t t) {
+            const BatchTask& task = tasks[t];
+            if (task.vectorized) {
+                vector<const vector<Process>*> group;
+                for (size_t w = task.firstWorkload; w < task.firstWorkload + task.workloadCount; w++) {
+                    group.push_back(workloads[w].get());
+                }
+                vector<AlgorithmResult> groupResults = fcfsBatch(group, options);
+                for (size_t i = 0; i < groupResults.size(); i++) {
+                    results[(task.firstWorkload + i) * algorithms.size() + task.algorithm] = std::move(groupResults[i]);
+                }
+                return;
+            }
+            size_t cell = task.firstWorkload * algorithms.size() + task.algorithm;
+            results[cell] = algorithms[task.algorithm]->run(*workloads[task.firstWorkload], algorithmParams, options);
+        });
+
+        crow::json::wvalue response;
+        crow::json::wvalue cells = crow::json::wvalue::list();
+        for (size_t cell = 0; cell < cellCount; cell++) {
+            cells[cell] = cellJson(cell, results[cell]);
         }
+        response["cells"] = std::move(cells);
 
         crow::response res(response);
         res.set_header("Content-Type", "application/json");
@@ -701,6 +5983,6 @@ int main() {
     });
 
     // Run the app on port 8080
-    app.port(8080).run();
+    app.port(8080).multithreaded().run();
     return 0;
 }